@@ -0,0 +1,80 @@
+#include <Arduino.h>
+#include <carmeleonClient.h>
+
+#define BULTIN_LED 2
+
+carmeleonClient carmeleon;
+
+//ENC28J60Driver driver;
+//EMACDriver driver(ETH_PHY_LAN8720);
+W5500Driver driver;
+/*
+3v3-3.3v
+GND-GND
+D5-SCS
+D18-SCLK
+D23-MOSI
+D19-MISO
+D34-RST
+*/
+
+const char* UserAgent = "CARMELEON_CLIENT";
+byte mac[] = { 0x1A, 0xAA, 0xBB, 0xCC, 0x00, 0x01 };  // 맥주소
+IPAddress dns1(168, 126, 63, 1); // DNS정보 (KT)
+IPAddress dns2(1, 1, 1, 1); //DNS2차정보 (cloudflare)
+
+void setup() {
+
+    pinMode(BULTIN_LED, OUTPUT);
+    digitalWrite(BULTIN_LED, LOW);
+
+    Serial.begin(115200);
+    while (!Serial);
+
+    //네트워크 칩관련 설정
+    carmeleon.Eth.init(driver); 
+
+    carmeleon.Eth.setHostname("helloworld"); //네트워크상에 출력하는 호스트네임 지정
+    carmeleon.Eth.setDNS(dns1, dns2); //DNS서버 지정
+
+    Serial.println("Ethernet연결 시도 중...");
+    //이더넷 연결시작 (맥주소)
+    while (carmeleon.Eth.begin(mac) == 0) {
+        Serial.println("Ethernet연결 재시도!");
+        delay(50);
+    }
+
+    Serial.println("NTP서버 동기화중 : "); 
+    carmeleon.Eth.setNTP("time.bora.net"); //NTP서버 지정 및 시간정보 동기화 실행
+    time_t now = time(nullptr);
+    Serial.printf("NTP 동기화완료(KST): %s", ctime(&now));
+
+    //비동기 엔진 시작 (동시에 처리할 요청 수)
+    carmeleon.Async.begin(2);
+
+}
+
+uint32_t lastSample = 0;
+uint32_t lastRequest = 0;
+
+void loop(){
+
+    //요청은 큐에 넣고 바로 돌아오므로 센서 샘플링 주기가 유지됨
+    if (millis() - lastRequest > 5000) {
+        lastRequest = millis();
+
+        carmeleon.Async.get("https://postman-echo.com/get", [](HttpAsyncResponse& res) {
+            Serial.printf("[GET #%lu] 응답 코드: %d, %u bytes\n", (unsigned long)res.id, res.statusCode, res.body.length());
+        });
+
+        carmeleon.Async.post("https://postman-echo.com/post", "{\"hello\":\"world\"}", "application/json", [](HttpAsyncResponse& res) {
+            Serial.printf("[POST #%lu] 응답 코드: %d, Content-Type: %s\n", (unsigned long)res.id, res.statusCode, res.header("Content-Type").c_str());
+        });
+    }
+
+    if (millis() - lastSample > 10) {
+        lastSample = millis();
+        digitalWrite(BULTIN_LED, !digitalRead(BULTIN_LED));   //센서 샘플링 자리
+    }
+
+}
@@ -67,14 +67,14 @@ void setup() {
         Serial.println("❌ 웹소켓 끊김!");
     });
 
-    carmeleon.Http.onMsgString([](String msg) {
+    carmeleon.Http.onMsgString([](const String& msg) {
         Serial.printf("📨 문자열 수신: %s\n", msg.c_str());
 
         if( msg == "hi" ){
             Serial.printf("HI수신!");
         }
     });
-    carmeleon.Http.onMsgBinary([](std::vector<uint8_t> data) {
+    carmeleon.Http.onMsgBinary([](const std::vector<uint8_t>& data) {
         Serial.printf("📦 바이너리 수신 (%d바이트): ", data.size());
         for (auto b : data) Serial.printf("%02X ", b);
         Serial.println();
@@ -115,12 +115,12 @@ void setup() {
 	Serial.println("ws 연결끊김!");
   });
 
-  evt->onReceiveString([](String res){
+  evt->onReceiveString([](const String& res){
 	Serial.print("문자열응답 : ");
 	Serial.println(res);
   });
 
-  evt->onReceive([](Response res){
+  evt->onReceive([](Response& res){
 	Serial.println("전체응답보기 : ");
 	res.prettyPrint(); // 전체 응답 보기
 	if (!res.is<bool>("is_success")) {
@@ -0,0 +1,163 @@
+#include "Codec.h"
+
+static const char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char HEX_CHARS[] = "0123456789abcdef";
+
+static const int8_t B64_SKIP = -2;
+static const int8_t B64_BAD = -1;
+
+// 문자 → 6비트 값 (-1: 잘못된 문자, -2: 건너뛸 문자)
+static const int8_t BASE64_VALUES[256] = {
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-2,-2,-1,-1,-2,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,62,-1,-1,-1,63,
+  52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-1,-1,-1,
+  -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
+  15,16,17,18,19,20,21,22,23,24,25,-1,-2,-1,-1,-1,
+  -1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
+  41,42,43,44,45,46,47,48,49,50,51,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+};
+
+// 문자 → 4비트 값 (-1: 16진수 아님)
+static const int8_t HEX_VALUES[256] = {
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+   0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,
+  -1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+};
+
+
+size_t Codec::base64Encode(const uint8_t* in, size_t len, char* out) {
+  char* o = out;
+  size_t i = 0;
+
+  // 3바이트 → 4문자
+  for (; i + 3 <= len; i += 3) {
+    uint32_t triple = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+    o[0] = BASE64_CHARS[(triple >> 18) & 63];
+    o[1] = BASE64_CHARS[(triple >> 12) & 63];
+    o[2] = BASE64_CHARS[(triple >> 6) & 63];
+    o[3] = BASE64_CHARS[triple & 63];
+    o += 4;
+  }
+
+  if (i < len) {
+    uint32_t triple = (uint32_t)in[i] << 16;
+    if (i + 1 < len) triple |= (uint32_t)in[i + 1] << 8;
+    o[0] = BASE64_CHARS[(triple >> 18) & 63];
+    o[1] = BASE64_CHARS[(triple >> 12) & 63];
+    o[2] = (i + 1 < len) ? BASE64_CHARS[(triple >> 6) & 63] : '=';
+    o[3] = '=';
+    o += 4;
+  }
+
+  *o = '\0';
+  return o - out;
+}
+
+String Codec::base64Encode(const uint8_t* in, size_t len) {
+  String out;
+  out.reserve(base64EncodedLength(len));
+
+  // 작은 스택 버퍼 단위로 인코딩해서 이어 붙임 (48바이트 → 64문자)
+  char chunk[65];
+  for (size_t i = 0; i < len; i += 48) {
+    size_t n = len - i < 48 ? len - i : 48;
+    size_t written = base64Encode(in + i, n, chunk);
+    out.concat(chunk, written);
+  }
+  return out;
+}
+
+bool Codec::base64Decode(const char* in, size_t len, uint8_t* out, size_t& outLen) {
+  const uint8_t* p = (const uint8_t*)in;
+  const uint8_t* end = p + len;
+  uint8_t* o = out;
+
+  // 건너뛸 문자가 없는 4문자 묶음은 한 번에 처리
+  while (end - p >= 4) {
+    int8_t a = BASE64_VALUES[p[0]], b = BASE64_VALUES[p[1]];
+    int8_t c = BASE64_VALUES[p[2]], d = BASE64_VALUES[p[3]];
+    if ((a | b | c | d) < 0) break;
+    uint32_t quad = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+    o[0] = quad >> 16;
+    o[1] = quad >> 8;
+    o[2] = quad;
+    o += 3;
+    p += 4;
+  }
+
+  // 나머지 (패딩, 이스케이프, 줄바꿈이 섞인 부분)
+  uint32_t acc = 0;
+  int bits = 0;
+  for (; p < end; p++) {
+    if (*p == '=') break;
+    int8_t v = BASE64_VALUES[*p];
+    if (v == B64_SKIP) continue;
+    if (v == B64_BAD) return false;
+
+    acc = (acc << 6) | (uint32_t)v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      *o++ = acc >> bits;
+    }
+  }
+
+  outLen = o - out;
+  return true;
+}
+
+void Codec::hexEncode(const uint8_t* in, size_t len, char* out) {
+  for (size_t i = 0; i < len; i++) {
+    out[i * 2] = HEX_CHARS[in[i] >> 4];
+    out[i * 2 + 1] = HEX_CHARS[in[i] & 0x0F];
+  }
+  out[len * 2] = '\0';
+}
+
+String Codec::hexEncode(const uint8_t* in, size_t len) {
+  String out;
+  out.reserve(len * 2);
+
+  char chunk[65];
+  for (size_t i = 0; i < len; i += 32) {
+    size_t n = len - i < 32 ? len - i : 32;
+    hexEncode(in + i, n, chunk);
+    out.concat(chunk, n * 2);
+  }
+  return out;
+}
+
+bool Codec::hexDecode(const char* in, size_t len, uint8_t* out, size_t& outLen) {
+  if (len % 2) return false;
+  const uint8_t* p = (const uint8_t*)in;
+  for (size_t i = 0; i < len; i += 2) {
+    int8_t hi = HEX_VALUES[p[i]];
+    int8_t lo = HEX_VALUES[p[i + 1]];
+    if ((hi | lo) < 0) return false;
+    out[i / 2] = (hi << 4) | lo;
+  }
+  outLen = len / 2;
+  return true;
+}
@@ -0,0 +1,27 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <Arduino.h>
+
+// Base64 / 16진수 변환 (표 기반, 호출자가 준 버퍼에 바로 씀)
+// 디코딩은 출력이 입력보다 항상 뒤처지므로 in == out 으로 제자리 변환해도 된다
+class Codec {
+public:
+  static size_t base64EncodedLength(size_t len) { return (len + 2) / 3 * 4; }
+  static size_t base64DecodedMaxLength(size_t len) { return len / 4 * 3 + 3; }
+
+  // out 에는 base64EncodedLength(len) + 1 바이트가 필요 (끝에 '\0')
+  static size_t base64Encode(const uint8_t* in, size_t len, char* out);
+  static String base64Encode(const uint8_t* in, size_t len);
+
+  // '=' 에서 끝남. JSON 안의 값을 그대로 넘길 수 있도록 역슬래시("\/")와 공백은 건너뜀
+  static bool base64Decode(const char* in, size_t len, uint8_t* out, size_t& outLen);
+
+  // out 에는 len * 2 + 1 바이트가 필요 (소문자, 끝에 '\0')
+  static void hexEncode(const uint8_t* in, size_t len, char* out);
+  static String hexEncode(const uint8_t* in, size_t len);
+
+  static bool hexDecode(const char* in, size_t len, uint8_t* out, size_t& outLen);
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef DERIVED_KEY_CACHE_H
+#define DERIVED_KEY_CACHE_H
+
+#include <Arduino.h>
+#include <mbedtls/md.h>
+#include <mbedtls/pkcs5.h>
+#include "Sha256.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+struct DerivedKeyCacheStats {
+  uint32_t hits = 0;      // PBKDF2 없이 보관된 키 사용
+  uint32_t misses = 0;    // PBKDF2 계산
+  uint32_t deriveMs = 0;  // PBKDF2 누적 소요시간
+};
+
+
+// PBKDF2-HMAC-SHA512 로 파생한 AES 키를 (비밀키, salt, 반복 횟수) 별로 보관하는 LRU 캐시
+// 서버가 세션 동안 같은 salt 를 다시 쓰면 응답마다 하던 999회 HMAC 계산을 건너뛴다
+// 항목은 입력 전체의 SHA-256 으로 구분하므로 비밀키와 salt 원문은 보관하지 않는다
+class DerivedKeyCache {
+public:
+  static const size_t KEY_SIZE = 32;
+
+  static DerivedKeyCache& instance() {
+    static DerivedKeyCache cache;
+    return cache;
+  }
+
+  bool derive(const uint8_t* secret, size_t secretLen,
+              const uint8_t* salt, size_t saltLen,
+              uint32_t iterations, uint8_t out[KEY_SIZE]) {
+    uint8_t id[Sha256::HASH_SIZE];
+    fingerprint(secret, secretLen, salt, saltLen, iterations, id);
+
+    lock();
+    Entry* e = findLocked(id);
+    if (e) {
+      memcpy(out, e->key, KEY_SIZE);
+      e->lastUsed = ++_tick;
+      _stats.hits++;
+    } else {
+      _stats.misses++;
+    }
+    unlock();
+    if (e) return true;
+
+    // 계산은 잠금 밖에서 (다른 태스크의 캐시 적중을 막지 않도록)
+    uint32_t start = millis();
+    int ret = mbedtls_pkcs5_pbkdf2_hmac_ext(
+      MBEDTLS_MD_SHA512,
+      secret, secretLen,
+      salt, saltLen,
+      iterations,
+      KEY_SIZE,
+      out
+    );
+    if (ret != 0) return false;
+
+    lock();
+    _stats.deriveMs += millis() - start;
+    store(id, out);
+    unlock();
+    return true;
+  }
+
+  void setCapacity(uint8_t n) {   // 보관할 키 개수 (기본 4, 0 이면 캐시 안 함)
+    lock();
+    _capacity = n;
+    while (_entries.size() > _capacity) evictLocked();
+    unlock();
+  }
+
+  void clear() {
+    lock();
+    while (!_entries.empty()) evictLocked();
+    unlock();
+  }
+
+  bool enabled() { return _capacity > 0; }
+
+  DerivedKeyCacheStats stats() {
+    lock();
+    DerivedKeyCacheStats s = _stats;
+    unlock();
+    return s;
+  }
+
+  void printStats() {
+    DerivedKeyCacheStats s = stats();
+    uint32_t total = s.hits + s.misses;
+    Serial.println("[Decrypt] 키 파생 캐시 통계 : ");
+    Serial.printf("  적중: %u회\n", (unsigned)s.hits);
+    Serial.printf("  계산: %u회 (평균 %u ms)\n", (unsigned)s.misses, (unsigned)(s.misses ? s.deriveMs / s.misses : 0));
+    Serial.printf("  적중률: %u%%\n", (unsigned)(total ? s.hits * 100 / total : 0));
+  }
+
+private:
+  struct Entry {
+    uint8_t id[Sha256::HASH_SIZE];
+    uint8_t key[KEY_SIZE];
+    uint32_t lastUsed;
+  };
+
+  std::vector<Entry> _entries;
+  uint8_t _capacity = 4;
+  uint32_t _tick = 0;
+  DerivedKeyCacheStats _stats;
+  SemaphoreHandle_t _lock = nullptr;
+
+  DerivedKeyCache() = default;
+
+  static void fingerprint(const uint8_t* secret, size_t secretLen,
+                          const uint8_t* salt, size_t saltLen,
+                          uint32_t iterations, uint8_t id[Sha256::HASH_SIZE]) {
+    // 길이를 앞에 넣어 (비밀키, salt) 경계가 달라도 같은 입력이 되지 않게 함
+    uint8_t header[12];
+    uint32_t fields[3] = { iterations, (uint32_t)secretLen, (uint32_t)saltLen };
+    for (int i = 0; i < 3; i++) {
+      header[i * 4]     = fields[i] >> 24;
+      header[i * 4 + 1] = fields[i] >> 16;
+      header[i * 4 + 2] = fields[i] >> 8;
+      header[i * 4 + 3] = fields[i];
+    }
+    Sha256 sha;
+    sha.update(header, sizeof(header));
+    sha.update(secret, secretLen);
+    sha.update(salt, saltLen);
+    sha.finish(id);
+  }
+
+  Entry* findLocked(const uint8_t* id) {
+    for (Entry& e : _entries) {
+      if (memcmp(e.id, id, sizeof(e.id)) == 0) return &e;
+    }
+    return nullptr;
+  }
+
+  void store(const uint8_t* id, const uint8_t* key) {
+    if (_capacity == 0 || findLocked(id)) return;
+    if (_entries.size() >= _capacity) evictLocked();
+    Entry e;
+    memcpy(e.id, id, sizeof(e.id));
+    memcpy(e.key, key, KEY_SIZE);
+    e.lastUsed = ++_tick;
+    _entries.push_back(e);
+  }
+
+  void evictLocked() {   // 가장 오래 쓰지 않은 키를 지움
+    size_t lru = 0;
+    for (size_t i = 1; i < _entries.size(); i++) {
+      if ((int32_t)(_entries[i].lastUsed - _entries[lru].lastUsed) < 0) lru = i;
+    }
+    memset(_entries[lru].key, 0, KEY_SIZE);
+    _entries.erase(_entries.begin() + lru);
+  }
+
+  void lock() {
+    // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+    if (_lock == nullptr) {
+      _lock = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+  }
+
+  void unlock() {
+    xSemaphoreGive(_lock);
+  }
+};
+
+#endif
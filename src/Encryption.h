@@ -1,86 +1,73 @@
 #include "ArduinoJson/ArduinoJson.h"
 #include <string>
 #include <vector>
-#include <mbedtls/base64.h>
 #include <mbedtls/aes.h>
+#include <mbedtls/gcm.h>
 #include <mbedtls/md.h>
 #include <mbedtls/pkcs5.h>
+#include "DerivedKeyCache.h"
+#include "Codec.h"
 
 #define MBEDTLS_PKCS5_C
 
 class Encryption {
 private:
-    String bytesToHex(const uint8_t* data, size_t length) {
-        String hex;
-        hex.reserve(length * 2);
-        for (size_t i = 0; i < length; i++) {
-            char buf[3];
-            sprintf(buf, "%02x", data[i]);
-            hex += buf;
-        }
-        return hex;
-    }
-
-    std::vector<uint8_t> hexToBytes(const String& hex) {
-        std::vector<uint8_t> bytes;
-        bytes.reserve(hex.length() / 2);
-        for (size_t i = 0; i < hex.length(); i += 2) {
-            String byteStr = hex.substring(i, i + 2);
-            bytes.push_back(strtol(byteStr.c_str(), nullptr, 16));
-        }
-        return bytes;
-    }
-
-    String base64Encode(const uint8_t* input, size_t length) {
-        if (!input || length == 0) {
-            Serial.println("[CustomBase64] Invalid input");
-            return "";
-        }
-
-        const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-        String output;
-        output.reserve(((length + 2) / 3) * 4);
-
-        for (size_t i = 0; i < length; i += 3) {
-            uint32_t octet_a = i < length ? input[i] : 0;
-            uint32_t octet_b = i + 1 < length ? input[i + 1] : 0;
-            uint32_t octet_c = i + 2 < length ? input[i + 2] : 0;
+    // 봉투 JSON({"ciphertext":"..","iv":"..","salt":"..","iterations":999}) 에서 필드 값 위치를 찾음
+    // 값은 복사하지 않고 버퍼 안의 위치만 돌려준다 (문자열이면 따옴표 안쪽)
+    static bool envelopeField(uint8_t* json, size_t len, const char* name, uint8_t*& value, size_t& valueLen) {
+        size_t nameLen = strlen(name);
+        for (size_t i = 0; i + nameLen + 2 <= len; i++) {
+            if (json[i] != '"' || json[i + nameLen + 1] != '"' || memcmp(json + i + 1, name, nameLen) != 0) continue;
 
-            uint32_t triple = (octet_a << 16) + (octet_b << 8) + octet_c;
+            size_t p = i + nameLen + 2;
+            while (p < len && isspace(json[p])) p++;
+            if (p >= len || json[p] != ':') continue;   // 키가 아니라 값에 나온 같은 문자열
+            p++;
+            while (p < len && isspace(json[p])) p++;
+            if (p >= len) return false;
 
-            output += base64_chars[(triple >> 18) & 63];
-            output += base64_chars[(triple >> 12) & 63];
-            output += (i + 1 < length) ? base64_chars[(triple >> 6) & 63] : '=';
-            output += (i + 2 < length) ? base64_chars[triple & 63] : '=';
+            if (json[p] == '"') {
+                size_t start = ++p;
+                while (p < len && json[p] != '"') {
+                    if (json[p] == '\\') p++;
+                    p++;
+                }
+                if (p >= len) return false;
+                value = json + start;
+                valueLen = p - start;
+            } else {
+                size_t start = p;
+                while (p < len && json[p] != ',' && json[p] != '}' && !isspace(json[p])) p++;
+                value = json + start;
+                valueLen = p - start;
+            }
+            return true;
         }
-
-        Serial.print("[CustomBase64] Encoded: ");
-        Serial.println(output);
-        return output;
+        return false;
     }
 
-    bool base64Decode(const String& input, std::vector<uint8_t>& output) {
-        if (input.isEmpty()) {
-            Serial.println("[Base64] Decode failed: empty input");
-            return false;
-        }
-
-        // Base64 디코딩 예상 크기
-        size_t maxOutputLen = (input.length() * 3) / 4 + 1;
-        output.resize(maxOutputLen);
+    // v2 봉투: [버전 1][반복 횟수 4 (BE)][salt 길이 1][salt][nonce 12][암호문][태그 16]
+    // 태그는 암호문 앞의 헤더 전체를 추가 인증 데이터로 포함한다
+    static const size_t V2_NONCE_SIZE = 12;
+    static const size_t V2_TAG_SIZE = 16;
+    static const size_t V2_SALT_SIZE = 16;
 
-        size_t outlen = 0;
-        int ret = mbedtls_base64_decode(output.data(), maxOutputLen, &outlen,
-                                       (const uint8_t*)input.c_str(), input.length());
-        if (ret != 0) {
-            Serial.printf("[Base64] Decode failed, error code: %d\n", ret);
-            return false;
-        }
-        output.resize(outlen); // 실제 디코딩된 크기로 조정
-        return true;
+    // 이 장치가 v2 로 암호화할 때 쓰는 salt (부팅 후 한 번 생성 → 키 파생도 한 번)
+    static const uint8_t* sessionSalt() {
+        struct Salt {
+            uint8_t bytes[V2_SALT_SIZE];
+            Salt() { esp_fill_random(bytes, sizeof(bytes)); }
+        };
+        static Salt salt;
+        return salt.bytes;
     }
 
 public:
+    static const uint8_t ENVELOPE_V1 = 1;   // Base64(JSON{ciphertext, iv, salt, iterations}), PBKDF2 + AES-256-CBC
+    static const uint8_t ENVELOPE_V2 = 2;   // 바이너리, 세션 키(salt 별 PBKDF2 한 번) + AES-256-GCM
+    static const size_t V2_MAX_ENVELOPE = 32768;   // 받아들이는 v2 응답 본문의 최대 크기 (힙 보호)
+    static const uint32_t MAX_ITERATIONS = 100000;  // 봉투가 요구할 수 있는 PBKDF2 반복 횟수 상한 (인증 전 값이므로)
+
     String encrypt(const String& plaintext, const String& key) {
         // 1. IV와 Salt 생성
         uint8_t iv[16], salt[256];
@@ -129,7 +116,7 @@ public:
         mbedtls_aes_free(&aes);
 
         // 5. 암호문 Base64 인코딩
-        String base64Cipher = base64Encode(encrypted.data(), paddedLen);
+        String base64Cipher = Codec::base64Encode(encrypted.data(), paddedLen);
         if (base64Cipher.isEmpty()) {
             Serial.println("[Encrypt] Failed to encode ciphertext");
             return "";
@@ -138,15 +125,19 @@ public:
         // 6. JSON 객체 생성
         DynamicJsonDocument doc(2048); // Salt가 크므로 충분한 크기 확보
         doc["ciphertext"] = base64Cipher;
-        doc["iv"] = bytesToHex(iv, sizeof(iv));
-        doc["salt"] = bytesToHex(salt, sizeof(salt));
+        char ivHex[sizeof(iv) * 2 + 1];
+        char saltHex[sizeof(salt) * 2 + 1];
+        Codec::hexEncode(iv, sizeof(iv), ivHex);
+        Codec::hexEncode(salt, sizeof(salt), saltHex);
+        doc["iv"] = ivHex;
+        doc["salt"] = saltHex;
         doc["iterations"] = 999;
 
         String jsonStr;
         serializeJson(doc, jsonStr);
 
         // 7. JSON 문자열 Base64 인코딩
-        String finalOutput = base64Encode((const uint8_t*)jsonStr.c_str(), jsonStr.length());
+        String finalOutput = Codec::base64Encode((const uint8_t*)jsonStr.c_str(), jsonStr.length());
         if (finalOutput.isEmpty()) {
             Serial.println("[Encrypt] Failed to encode JSON");
             return "";
@@ -155,85 +146,204 @@ public:
         return finalOutput;
     }
 
-    String decrypt(const String& encryptedString, const String& key) {
-        // 1. Base64 디코딩
-        std::vector<uint8_t> decoded;
-        if (!base64Decode(encryptedString, decoded)) {
+    // 서버 응답(Base64(봉투 JSON))을 out 하나의 버퍼 안에서 모두 처리해 평문을 out 에 남김
+    // 바깥 Base64 → 봉투 필드 위치 확인 → 암호문/iv/salt 를 제자리 디코딩 → AES-256-CBC 제자리 복호화
+    bool decryptTo(const char* encrypted, size_t len, const String& key, std::vector<uint8_t>& out) {
+        // 1. 바깥 Base64 (원본은 응답 문서 안에 있으므로 여기서 한 번만 복사)
+        out.assign((const uint8_t*)encrypted, (const uint8_t*)encrypted + len);
+        size_t envLen = 0;
+        if (len == 0 || !Codec::base64Decode((const char*)out.data(), len, out.data(), envLen)) {
             Serial.println("[Decrypt] Base64 decode failed");
-            return "";
+            return false;
         }
 
-        // 2. JSON 파싱
-        DynamicJsonDocument doc(2048);
-        if (deserializeJson(doc, decoded.data(), decoded.size())) {
+        // 2. 봉투 필드 (복사 없이 위치만)
+        uint8_t* cipher; size_t cipherLen;
+        uint8_t* ivHex; size_t ivHexLen;
+        uint8_t* saltHex; size_t saltHexLen;
+        uint8_t* iterText; size_t iterTextLen;
+        uint8_t* env = out.data();
+        if (!envelopeField(env, envLen, "ciphertext", cipher, cipherLen) ||
+            !envelopeField(env, envLen, "iv", ivHex, ivHexLen) ||
+            !envelopeField(env, envLen, "salt", saltHex, saltHexLen)) {
             Serial.println("[Decrypt] JSON parse failed");
-            return "";
+            return false;
+        }
+        uint32_t iterations = 999;
+        if (envelopeField(env, envLen, "iterations", iterText, iterTextLen)) {
+            iterations = 0;
+            for (size_t i = 0; i < iterTextLen && isdigit(iterText[i]); i++) {
+                iterations = iterations * 10 + (iterText[i] - '0');
+                if (iterations > MAX_ITERATIONS) break;   // 넘치기 전에 멈춤
+            }
+        }
+        if (iterations == 0 || iterations > MAX_ITERATIONS) {
+            Serial.println("[Decrypt] Invalid iterations");
+            return false;
         }
 
-        String ciphertext = doc["ciphertext"].as<String>();
-        String ivStr = doc["iv"].as<String>();
-        String saltStr = doc["salt"].as<String>();
-        int iterations = doc["iterations"] | 999;
-
-        // 3. Hex 문자열을 바이트로 변환
-        std::vector<uint8_t> iv = hexToBytes(ivStr);
-        std::vector<uint8_t> salt = hexToBytes(saltStr);
+        // 3. Hex / Base64 를 각 필드 자리에 디코딩 (필드끼리 겹치지 않음)
+        size_t ivLen, saltLen;
+        if (!Codec::hexDecode((const char*)ivHex, ivHexLen, ivHex, ivLen) || ivLen != 16 ||
+            !Codec::hexDecode((const char*)saltHex, saltHexLen, saltHex, saltLen)) {
+            Serial.println("[Decrypt] Invalid iv/salt");
+            return false;
+        }
+        if (!Codec::base64Decode((const char*)cipher, cipherLen, cipher, cipherLen) || cipherLen == 0 || cipherLen % 16) {
+            Serial.println("[Decrypt] Ciphertext decode failed");
+            return false;
+        }
 
-        // 4. 키 파생
+        // 4. 키 파생 (같은 비밀키/salt/반복 횟수면 캐시된 키 사용)
         uint8_t derivedKey[32];
-        int ret = mbedtls_pkcs5_pbkdf2_hmac_ext(
-            MBEDTLS_MD_SHA512,
-            (const uint8_t*)key.c_str(), key.length(),
-            salt.data(), salt.size(),
-            iterations,
-            sizeof(derivedKey),
-            derivedKey
-        );
-        if (ret != 0) {
+        if (!DerivedKeyCache::instance().derive(
+                (const uint8_t*)key.c_str(), key.length(),
+                saltHex, saltLen,
+                iterations,
+                derivedKey)) {
             Serial.println("[Decrypt] Key derivation failed");
-            return "";
-        }
-
-        // 5. 암호문 Base64 디코딩
-        std::vector<uint8_t> encryptedData;
-        if (!base64Decode(ciphertext, encryptedData)) {
-            Serial.println("[Decrypt] Ciphertext decode failed");
-            return "";
+            return false;
         }
 
-        // 6. AES-256-CBC 복호화
-        std::vector<uint8_t> decrypted(encryptedData.size());
+        // 5. AES-256-CBC 제자리 복호화 (ESP32 에서는 mbedTLS 가 AES 하드웨어를 사용)
+        uint8_t iv[16];
+        memcpy(iv, ivHex, sizeof(iv));
         mbedtls_aes_context aes;
         mbedtls_aes_init(&aes);
-        ret = mbedtls_aes_setkey_dec(&aes, derivedKey, 256);
-        if (ret != 0) {
-            Serial.println("[Decrypt] AES key setup failed");
-            mbedtls_aes_free(&aes);
-            return "";
+        int ret = mbedtls_aes_setkey_dec(&aes, derivedKey, 256);
+        memset(derivedKey, 0, sizeof(derivedKey));
+        if (ret == 0) {
+            ret = mbedtls_aes_crypt_cbc(&aes, MBEDTLS_AES_DECRYPT, cipherLen, iv, cipher, cipher);
         }
-        ret = mbedtls_aes_crypt_cbc(
-            &aes, MBEDTLS_AES_DECRYPT,
-            encryptedData.size(),
-            iv.data(),
-            encryptedData.data(),
-            decrypted.data()
-        );
+        mbedtls_aes_free(&aes);
         if (ret != 0) {
             Serial.println("[Decrypt] AES decryption failed");
-            mbedtls_aes_free(&aes);
-            return "";
+            return false;
         }
-        mbedtls_aes_free(&aes);
 
-        // 7. PKCS#7 패딩 제거
-        size_t padLength = decrypted[encryptedData.size() - 1];
+        // 6. PKCS#7 패딩 제거 후 평문을 버퍼 앞으로
+        size_t padLength = cipher[cipherLen - 1];
         if (padLength > 16 || padLength == 0) {
             Serial.println("[Decrypt] Invalid padding");
-            return "";
+            return false;
+        }
+        size_t plainLen = cipherLen - padLength;
+        memmove(out.data(), cipher, plainLen);
+        out.resize(plainLen);
+        return true;
+    }
+
+    // v2 봉투로 암호화 (salt 는 세션 동안 같으므로 키 파생은 캐시에서 한 번만)
+    bool encryptV2(const uint8_t* plain, size_t len, const String& key, std::vector<uint8_t>& out,
+                   uint32_t iterations = 999) {
+        const uint8_t* salt = sessionSalt();
+        uint8_t sessionKey[32];
+        if (!DerivedKeyCache::instance().derive(
+                (const uint8_t*)key.c_str(), key.length(),
+                salt, V2_SALT_SIZE,
+                iterations,
+                sessionKey)) {
+            Serial.println("[Encrypt] Key derivation failed");
+            return false;
+        }
+
+        size_t headerLen = 1 + 4 + 1 + V2_SALT_SIZE;
+        out.resize(headerLen + V2_NONCE_SIZE + len + V2_TAG_SIZE);
+        uint8_t* p = out.data();
+        p[0] = ENVELOPE_V2;
+        p[1] = iterations >> 24;
+        p[2] = iterations >> 16;
+        p[3] = iterations >> 8;
+        p[4] = iterations;
+        p[5] = V2_SALT_SIZE;
+        memcpy(p + 6, salt, V2_SALT_SIZE);
+        uint8_t* nonce = p + headerLen;
+        esp_fill_random(nonce, V2_NONCE_SIZE);
+        uint8_t* cipher = nonce + V2_NONCE_SIZE;
+
+        mbedtls_gcm_context gcm;
+        mbedtls_gcm_init(&gcm);
+        int ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, sessionKey, 256);
+        memset(sessionKey, 0, sizeof(sessionKey));
+        if (ret == 0) {
+            ret = mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, len,
+                                            nonce, V2_NONCE_SIZE,
+                                            p, headerLen,
+                                            plain, cipher,
+                                            V2_TAG_SIZE, cipher + len);
+        }
+        mbedtls_gcm_free(&gcm);
+        if (ret != 0) {
+            Serial.println("[Encrypt] AES-GCM encryption failed");
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // v2 봉투를 buf 안에서 제자리로 복호화하고 평문만 buf 에 남김 (태그가 맞지 않으면 실패)
+    bool decryptV2(std::vector<uint8_t>& buf, const String& key) {
+        uint8_t* p = buf.data();
+        size_t len = buf.size();
+        if (len < 6 || p[0] != ENVELOPE_V2) {
+            Serial.println("[Decrypt] Unknown envelope");
+            return false;
+        }
+        uint32_t iterations = ((uint32_t)p[1] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 8) | p[4];
+        size_t saltLen = p[5];
+        size_t headerLen = 6 + saltLen;
+        if (iterations == 0 || len < headerLen + V2_NONCE_SIZE + V2_TAG_SIZE) {
+            Serial.println("[Decrypt] Truncated envelope");
+            return false;
+        }
+        // 태그 확인 전에 키를 파생하므로 헤더의 반복 횟수를 그대로 믿지 않음
+        if (iterations > MAX_ITERATIONS) {
+            Serial.println("[Decrypt] Invalid iterations");
+            return false;
+        }
+
+        // 서버가 세션 동안 같은 salt 를 쓰므로 대부분 캐시 적중
+        uint8_t sessionKey[32];
+        if (!DerivedKeyCache::instance().derive(
+                (const uint8_t*)key.c_str(), key.length(),
+                p + 6, saltLen,
+                iterations,
+                sessionKey)) {
+            Serial.println("[Decrypt] Key derivation failed");
+            return false;
         }
-        size_t decryptedLen = encryptedData.size() - padLength;
-        String result((char*)decrypted.data(), decryptedLen);
 
-        return result;
+        const uint8_t* nonce = p + headerLen;
+        uint8_t* cipher = p + headerLen + V2_NONCE_SIZE;
+        size_t cipherLen = len - headerLen - V2_NONCE_SIZE - V2_TAG_SIZE;
+
+        mbedtls_gcm_context gcm;
+        mbedtls_gcm_init(&gcm);
+        int ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, sessionKey, 256);
+        memset(sessionKey, 0, sizeof(sessionKey));
+        if (ret == 0) {
+            ret = mbedtls_gcm_auth_decrypt(&gcm, cipherLen,
+                                           nonce, V2_NONCE_SIZE,
+                                           p, headerLen,
+                                           cipher + cipherLen, V2_TAG_SIZE,
+                                           cipher, cipher);
+        }
+        mbedtls_gcm_free(&gcm);
+        if (ret != 0) {
+            Serial.println("[Decrypt] AES-GCM authentication failed");
+            return false;
+        }
+
+        memmove(p, cipher, cipherLen);
+        buf.resize(cipherLen);
+        return true;
+    }
+
+    String decrypt(const String& encryptedString, const String& key) {
+        std::vector<uint8_t> plain;
+        if (!decryptTo(encryptedString.c_str(), encryptedString.length(), key, plain)) {
+            return "";
+        }
+        return String((const char*)plain.data(), plain.size());
     }
 };
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "DnsCache.h"
+
+#include <freertos/task.h>
+
+namespace {
+  struct PrefetchJob {
+    DnsCache* cache;
+    String host;
+  };
+}
+
+
+DnsCache::DnsCache(Resolver resolver) : _resolver(resolver) {
+}
+
+void DnsCache::lock() {
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (_lock == nullptr) {
+    _lock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void DnsCache::unlock() {
+  xSemaphoreGive(_lock);
+}
+
+DnsCache::Entry* DnsCache::findLocked(const char* host) {
+  for (Entry& e : _entries) {
+    if (e.host.equalsIgnoreCase(host)) return &e;
+  }
+  return nullptr;
+}
+
+bool DnsCache::inflightLocked(const char* host) {
+  for (const String& h : _inflight) {
+    if (h.equalsIgnoreCase(host)) return true;
+  }
+  return false;
+}
+
+void DnsCache::finishLocked(const char* host) {
+  for (size_t i = 0; i < _inflight.size(); i++) {
+    if (_inflight[i].equalsIgnoreCase(host)) {
+      _inflight.erase(_inflight.begin() + i);
+      return;
+    }
+  }
+}
+
+bool DnsCache::refreshDueLocked(const Entry& e, uint32_t now) {
+  // 수명의 마지막 1/4 에 들어선 성공 결과는 다음 요청이 기다리지 않도록 미리 갱신
+  return !e.negative && (e.expires - now) < _ttl * 250;
+}
+
+bool DnsCache::resolve(const char* host, IPAddress& ip) {
+  // IP 문자열은 질의할 필요가 없음
+  if (ip.fromString(host)) return true;
+
+  uint32_t waitStart = millis();
+  lock();
+  while (true) {
+    uint32_t now = millis();
+    Entry* e = findLocked(host);
+    if (e && (int32_t)(e->expires - now) > 0) {
+      e->lastUsed = now;
+      bool ok = !e->negative;
+      if (ok) ip = e->ip;
+
+      bool refresh = refreshDueLocked(*e, now) && !inflightLocked(host);
+      if (refresh) _inflight.push_back(host);
+
+      _stats.hits++;
+      if (!ok) _stats.negativeHits++;
+      unlock();
+
+      if (refresh) startPrefetch(host);
+      return ok;
+    }
+
+    // 다른 태스크(prefetch 포함)가 같은 호스트를 질의 중이면 따로 질의하지 않고 결과를 기다림
+    if (!inflightLocked(host) || millis() - waitStart >= WAIT_MS) break;
+    unlock();
+    delay(10);
+    lock();
+  }
+  bool owner = !inflightLocked(host);
+  if (owner) _inflight.push_back(host);
+  _stats.misses++;
+  unlock();
+
+  IPAddress addr;
+  bool ok = _resolver && _resolver(host, addr);
+  store(host, ok, addr);
+  if (owner) {
+    lock();
+    finishLocked(host);
+    unlock();
+  }
+  if (ok) ip = addr;
+  return ok;
+}
+
+bool DnsCache::prefetch(const char* host) {
+  IPAddress ip;
+  if (ip.fromString(host)) return true;
+
+  lock();
+  uint32_t now = millis();
+  Entry* e = findLocked(host);
+  bool fresh = e && (int32_t)(e->expires - now) > 0 && !refreshDueLocked(*e, now);
+  bool start = !fresh && !inflightLocked(host);
+  if (start) _inflight.push_back(host);
+  unlock();
+
+  if (start) startPrefetch(host);
+  return true;
+}
+
+void DnsCache::startPrefetch(const char* host) {
+  // 호출 전에 _inflight 에 넣어 두어야 함
+  PrefetchJob* job = new PrefetchJob{ this, String(host) };
+  if (xTaskCreate(prefetchTask, "dns_prefetch", 3072, job, 1, nullptr) != pdPASS) {
+    delete job;
+    lock();
+    finishLocked(host);
+    unlock();
+  }
+}
+
+void DnsCache::prefetchTask(void* arg) {
+  PrefetchJob* job = static_cast<PrefetchJob*>(arg);
+  DnsCache* self = job->cache;
+
+  IPAddress ip;
+  bool ok = self->_resolver && self->_resolver(job->host.c_str(), ip);
+
+  self->lock();
+  self->_stats.prefetches++;
+  Entry* e = self->findLocked(job->host.c_str());
+  bool keep = !ok && e && !e->negative && (int32_t)(e->expires - millis()) > 0;   // 갱신 실패 시 아직 유효한 기존 결과를 유지
+  self->unlock();
+
+  if (!keep) self->store(job->host.c_str(), ok, ip);
+
+  // 결과를 저장한 뒤에 풀어야 기다리던 resolve() 가 캐시에서 바로 찾음
+  self->lock();
+  self->finishLocked(job->host.c_str());
+  self->unlock();
+
+  delete job;
+  vTaskDelete(NULL);
+}
+
+void DnsCache::store(const char* host, bool ok, const IPAddress& ip) {
+  lock();
+  uint32_t now = millis();
+  Entry* e = findLocked(host);
+
+  if (!e) {
+    if (_capacity == 0) {
+      unlock();
+      return;
+    }
+    // 가득 차면 가장 오래 사용하지 않은 항목을 교체
+    if (_entries.size() >= _capacity) {
+      size_t lru = 0;
+      for (size_t i = 1; i < _entries.size(); i++) {
+        if ((int32_t)(_entries[i].lastUsed - _entries[lru].lastUsed) < 0) lru = i;
+      }
+      _entries.erase(_entries.begin() + lru);
+    }
+    _entries.emplace_back();
+    e = &_entries.back();
+    e->host = host;
+  }
+
+  e->ip = ok ? ip : IPAddress();
+  e->negative = !ok;
+  e->expires = now + (ok ? _ttl : _negativeTtl) * 1000;
+  e->lastUsed = now;
+  unlock();
+}
+
+void DnsCache::forget(const char* host) {
+  lock();
+  for (size_t i = 0; i < _entries.size(); i++) {
+    if (_entries[i].host.equalsIgnoreCase(host)) {
+      _entries.erase(_entries.begin() + i);
+      break;
+    }
+  }
+  unlock();
+}
+
+void DnsCache::clear() {
+  lock();
+  _entries.clear();
+  unlock();
+}
+
+void DnsCache::setCapacity(uint8_t n) {
+  lock();
+  _capacity = n;
+  while (_entries.size() > _capacity) {
+    _entries.erase(_entries.begin());
+  }
+  unlock();
+}
+
+void DnsCache::setTtl(uint32_t positiveSec, uint32_t negativeSec) {
+  lock();
+  _ttl = positiveSec;
+  _negativeTtl = negativeSec;
+  unlock();
+}
+
+DnsCacheStats DnsCache::stats() {
+  lock();
+  DnsCacheStats s = _stats;
+  unlock();
+  return s;
+}
@@ -0,0 +1,68 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+
+struct DnsCacheStats {
+  uint32_t hits = 0;          // 캐시에서 바로 응답 (실패 캐시 포함)
+  uint32_t misses = 0;        // 실제 DNS 질의
+  uint32_t negativeHits = 0;  // 최근 실패한 호스트라 질의 없이 실패 반환
+  uint32_t prefetches = 0;    // 백그라운드 조회 (명시적 prefetch + 만료 전 갱신)
+};
+
+
+// 호스트명 → IP 결과를 보관하는 LRU 캐시 (성공/실패 모두 TTL 동안 유지)
+// lwIP 는 응답의 TTL 을 알려주지 않으므로 TTL 은 설정값을 사용한다
+class DnsCache {
+public:
+  using Resolver = std::function<bool(const char* host, IPAddress& ip)>;
+
+  explicit DnsCache(Resolver resolver);
+
+  bool resolve(const char* host, IPAddress& ip);   // 캐시 확인 후 없으면 질의해서 저장
+  bool prefetch(const char* host);                  // 백그라운드 태스크에서 질의해 캐시를 채움 (유효하거나 조회 중이면 생략)
+  void forget(const char* host);                    // 연결 실패 등으로 결과를 믿을 수 없을 때
+  void clear();
+
+  void setCapacity(uint8_t n);
+  void setTtl(uint32_t positiveSec, uint32_t negativeSec);
+  DnsCacheStats stats();
+
+private:
+  struct Entry {
+    String host;
+    IPAddress ip;
+    bool negative = false;
+    uint32_t expires = 0;      // millis
+    uint32_t lastUsed = 0;
+  };
+
+  Resolver _resolver;
+  std::vector<Entry> _entries;
+  std::vector<String> _inflight;   // 질의 중인 호스트 (같은 호스트는 한 번만 질의하고 나머지는 결과를 기다림)
+  SemaphoreHandle_t _lock = nullptr;
+  uint8_t _capacity = 8;
+  uint32_t _ttl = 300;          // 초
+  uint32_t _negativeTtl = 10;   // 초
+  DnsCacheStats _stats;
+
+  static const uint32_t WAIT_MS = 10000;   // 다른 태스크의 질의를 기다리는 최대 시간
+
+  void lock();
+  void unlock();
+  Entry* findLocked(const char* host);
+  bool inflightLocked(const char* host);
+  void finishLocked(const char* host);
+  bool refreshDueLocked(const Entry& e, uint32_t now);
+  void store(const char* host, bool ok, const IPAddress& ip);
+  void startPrefetch(const char* host);
+  static void prefetchTask(void* arg);
+};
+
+#endif
@@ -33,6 +33,11 @@
 
 static uint8_t nextIndex = 0;
 
+// 캐시에 없을 때만 실제 질의 (UDP 왕복)
+static DnsCache dnsCache([](const char* host, IPAddress& ip) {
+  return Network.hostByName(host, ip) == 1;
+});
+
 EthernetClass::EthernetClass() {
   index = nextIndex;
   nextIndex++;
@@ -210,6 +215,7 @@ void EthernetClass::setDNS(IPAddress dns, IPAddress dns2) {
   if (dns2 != INADDR_NONE) {
     dnsIP(1, dns2);
   }
+  dnsCache.clear();  // 다른 서버의 결과와 섞이지 않도록
 }
 
 void EthernetClass::setHostname(const char* hostname) {
@@ -266,7 +272,28 @@ bool EthernetClass::setNTP(const char* ntpServer, long gmtOffset_sec, int daylig
 }
 
 int EthernetClass::hostByName(const char *hostname, IPAddress &result) {
-  return Network.hostByName(hostname, result);
+  return dnsCache.resolve(hostname, result) ? 1 : 0;
+}
+
+void EthernetClass::setDnsCache(uint8_t capacity, uint32_t ttlSec, uint32_t negativeTtlSec) {
+  dnsCache.setCapacity(capacity);
+  dnsCache.setTtl(ttlSec, negativeTtlSec);
+}
+
+bool EthernetClass::prefetch(const char *hostname) {
+  return dnsCache.prefetch(hostname);
+}
+
+void EthernetClass::forgetHost(const char *hostname) {
+  dnsCache.forget(hostname);
+}
+
+void EthernetClass::clearDnsCache() {
+  dnsCache.clear();
+}
+
+DnsCacheStats EthernetClass::dnsCacheStats() {
+  return dnsCache.stats();
 }
 
 size_t EthernetClass::printDriverInfo(Print &out) const {
@@ -24,6 +24,7 @@
 #include "Network.h"
 #include "esp_netif.h"
 #include "utility/EthDriver.h"
+#include "DnsCache.h"
 
 #include <time.h>
 #include <functional>
@@ -80,6 +81,13 @@ public:
 
   int hostByName(const char *hostname, IPAddress &result);
 
+  // DNS 캐시 (모든 EthernetClass 인스턴스가 공유)
+  void setDnsCache(uint8_t capacity, uint32_t ttlSec = 300, uint32_t negativeTtlSec = 10);
+  bool prefetch(const char *hostname);   // 곧 접속할 호스트를 백그라운드에서 미리 조회
+  void forgetHost(const char *hostname);
+  void clearDnsCache();
+  DnsCacheStats dnsCacheStats();
+
   virtual size_t printDriverInfo(Print &out) const;
 
   
@@ -0,0 +1,558 @@
+#include "CookieJar.h"
+
+#include <FS.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include "ArduinoJson/ArduinoJson.h"
+
+
+CookieJar& CookieJar::instance() {
+  static CookieJar jar;
+  return jar;
+}
+
+void CookieJar::lock() {
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (_lock == nullptr) {
+    _lock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void CookieJar::unlock() {
+  xSemaphoreGive(_lock);
+}
+
+void CookieJar::lockFlush() {
+  if (_flushLock == nullptr) {
+    _flushLock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_flushLock, portMAX_DELAY);
+}
+
+void CookieJar::unlockFlush() {
+  xSemaphoreGive(_flushLock);
+}
+
+String CookieJar::hostKey(const String& host) {
+  String key = host;
+  key.replace(":", "_"); // 포트 번호가 있는 경우 대체
+  return key;
+}
+
+String CookieJar::filePath(const String& key) {
+  return "/cookies/" + key + ".bin";
+}
+
+String CookieJar::legacyPath(const String& key) {
+  return "/cookies/" + key + ".json";
+}
+
+bool CookieJar::expired(const Cookie& c, time_t now) {
+  return c.expire > 0 && c.expire < now;   // UTC 비교
+}
+
+uint32_t CookieJar::crc32(const uint8_t* data, size_t len) {
+  // 레코드가 작아서 표 없이 비트 단위로 계산 (IEEE 802.3)
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static void putLE(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) out.push_back(v >> (i * 8));
+}
+
+static uint64_t getLE(const uint8_t* p, int bytes) {
+  uint64_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+  return v;
+}
+
+static void putField(std::vector<uint8_t>& out, const String& s, int lenBytes) {
+  putLE(out, s.length(), lenBytes);
+  out.insert(out.end(), (const uint8_t*)s.c_str(), (const uint8_t*)s.c_str() + s.length());
+}
+
+bool CookieJar::appendRecord(std::vector<uint8_t>& out, const Op& op) {
+  const Cookie& c = op.cookie;
+  if (c.name.length() > 0xFF || c.value.length() > 0xFFFF ||
+      c.domain.length() > 0xFF || c.path.length() > 0xFF) {
+    Serial.printf("[HTTP] 쿠키가 너무 커서 저장하지 않음: %s\n", c.name.c_str());
+    return false;
+  }
+
+  size_t start = out.size();
+  out.resize(start + RECORD_HEADER);   // 길이와 CRC 는 본문을 쓴 뒤 채움
+  out.push_back(op.remove ? 2 : 1);
+  putLE(out, (uint64_t)(int64_t)(op.remove ? 0 : c.expire), 8);
+  putField(out, c.name, 1);
+  putField(out, op.remove ? String() : c.value, 2);
+  putField(out, op.remove ? String() : c.domain, 1);
+  putField(out, op.remove ? String() : c.path, 1);
+
+  size_t bodyLen = out.size() - start - RECORD_HEADER;
+  uint32_t crc = crc32(out.data() + start + RECORD_HEADER, bodyLen);
+  for (int i = 0; i < 2; i++) out[start + i] = bodyLen >> (i * 8);
+  for (int i = 0; i < 4; i++) out[start + 2 + i] = crc >> (i * 8);
+  return true;
+}
+
+size_t CookieJar::parseRecords(const uint8_t* data, size_t len, std::vector<Cookie>& cookies, uint32_t& records) {
+  size_t pos = 0;
+  while (pos + RECORD_HEADER <= len) {
+    size_t bodyLen = getLE(data + pos, 2);
+    uint32_t crc = getLE(data + pos + 2, 4);
+    const uint8_t* body = data + pos + RECORD_HEADER;
+    if (pos + RECORD_HEADER + bodyLen > len || crc32(body, bodyLen) != crc) break;   // 쓰다 끊긴 꼬리
+
+    // 본문 안의 길이들도 범위를 확인
+    size_t p = 0;
+    auto field = [&](int lenBytes, String& out) -> bool {
+      if (p + lenBytes > bodyLen) return false;
+      size_t n = getLE(body + p, lenBytes);
+      p += lenBytes;
+      if (p + n > bodyLen) return false;
+      out = String((const char*)body + p, n);
+      p += n;
+      return true;
+    };
+
+    if (bodyLen < 9) break;
+    uint8_t kind = body[0];
+    Cookie c;
+    c.expire = (time_t)(int64_t)getLE(body + 1, 8);
+    p = 9;
+    if (!field(1, c.name) || !field(2, c.value) || !field(1, c.domain) || !field(1, c.path)) break;
+
+    for (size_t i = 0; i < cookies.size(); i++) {
+      if (cookies[i].name == c.name) {
+        cookies.erase(cookies.begin() + i);
+        break;
+      }
+    }
+    if (kind == 1) cookies.push_back(c);
+
+    records++;
+    pos += RECORD_HEADER + bodyLen;
+  }
+  return pos;
+}
+
+CookieJar::Host& CookieJar::hostLocked(const String& host) {
+  String key = hostKey(host);
+  for (Host& h : _hosts) {
+    if (h.key == key) {
+      loadLocked(h);
+      return h;
+    }
+  }
+  _hosts.emplace_back();
+  Host& h = _hosts.back();
+  h.key = key;
+  loadLocked(h);
+  return h;
+}
+
+void CookieJar::loadLocked(Host& h) {
+  if (h.loaded || !_storage) return;
+  h.loaded = true;
+
+  std::vector<Cookie> stored;
+  File file = LittleFS.open(filePath(h.key), "r");
+  if (!file) {
+    loadLegacyLocked(h);
+    return;
+  }
+
+  // 파일 전체를 한 번에 읽어서 순서대로 적용
+  std::vector<uint8_t> data(file.size());
+  size_t got = file.read(data.data(), data.size());
+  file.close();
+
+  if (got < 4 || memcmp(data.data(), "CKJ1", 4) != 0) {
+    Serial.printf("[HTTP] 쿠키 파일 형식 오류: %s\n", filePath(h.key).c_str());
+    h.compact = true;
+    return;
+  }
+  size_t used = 4 + parseRecords(data.data() + 4, got - 4, stored, h.logRecords);
+  if (used < got) {
+    Serial.printf("[HTTP] 쿠키 파일 끝 %u바이트 손상, 다음 저장 때 정리\n", (unsigned)(got - used));
+    h.compact = true;
+  }
+
+  // 마운트 전에 RAM 에서 바뀐 쿠키가 있으면 그쪽이 우선
+  time_t now = time(nullptr);
+  for (const Cookie& c : stored) {
+    if (expired(c, now)) continue;
+    bool touched = false;
+    for (const Op& op : h.pending) {
+      if (op.cookie.name == c.name) {
+        touched = true;
+        break;
+      }
+    }
+    if (!touched) h.cookies.push_back(c);
+  }
+}
+
+void CookieJar::loadLegacyLocked(Host& h) {
+  // 이전 버전의 JSON 파일은 한 번만 읽고, 다음 저장 때 바이너리로 옮긴다
+  String path = legacyPath(h.key);
+  File file = LittleFS.open(path, "r");
+  if (!file) return;
+
+  JsonDocument doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  h.compact = true;
+  if (err) {
+    Serial.printf("[HTTP] 쿠키 JSON 파싱 오류: %s\n", path.c_str());
+    return;
+  }
+
+  time_t now = time(nullptr);
+  for (JsonObject o : doc.as<JsonArray>()) {
+    const char* name = o["name"];
+    if (!name || !o["expire"].is<long long>()) continue;
+
+    bool touched = false;
+    for (const Op& op : h.pending) {
+      if (op.cookie.name == name) {
+        touched = true;
+        break;
+      }
+    }
+    if (touched) continue;
+
+    Cookie c;
+    c.name = name;
+    c.value = o["value"] | "";
+    c.domain = o["domain"] | "";
+    c.path = o["path"] | "/";
+    c.expire = (time_t)o["expire"].as<long long>();
+    if (!expired(c, now)) h.cookies.push_back(c);
+  }
+}
+
+void CookieJar::recordLocked(Host& h, const Cookie& c, bool remove) {
+  // 같은 쿠키의 이전 변경이 아직 안 쓰였으면 덮어씀
+  for (size_t i = 0; i < h.pending.size(); i++) {
+    if (h.pending[i].cookie.name == c.name) {
+      h.pending.erase(h.pending.begin() + i);
+      break;
+    }
+  }
+  Op op;
+  op.remove = remove;
+  op.cookie = c;
+  h.pending.push_back(op);
+  h.failures = 0;   // 새 변경이 생기면 쓰기를 다시 시도
+  scheduleFlushLocked();
+}
+
+void CookieJar::scheduleFlushLocked() {
+  if (!_storage) return;
+
+  if (_flushTask == nullptr) {
+    xTaskCreate(flushTask, "cookie_flush", 4096, this, 1, &_flushTask);
+  }
+  if (_flushTask) xTaskNotifyGive(_flushTask);
+}
+
+void CookieJar::flushTask(void* arg) {
+  CookieJar* self = static_cast<CookieJar*>(arg);
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // 변경이 잠잠해질 때까지 기다렸다가 한 번에 저장 (계속 바뀌어도 5배 이상은 미루지 않음)
+    uint32_t start = millis();
+    while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(self->_flushDelay)) > 0 &&
+           millis() - start < self->_flushDelay * 5) {
+    }
+    self->flush();
+  }
+}
+
+String CookieJar::header(const String& host) {
+  String result;
+  time_t now = time(nullptr);
+
+  lock();
+  Host& h = hostLocked(host);
+  for (size_t i = 0; i < h.cookies.size();) {
+    const Cookie& c = h.cookies[i];
+    if (expired(c, now)) {
+      // 파일에는 기록하지 않음 (읽을 때 만료된 레코드는 버리고, 압축 때 빠짐)
+      Serial.printf("[HTTP] 쿠키 만료됨: %s (만료시간: %lld, 현재: %ld)\n",
+                    c.name.c_str(), (long long)c.expire, now);
+      h.cookies.erase(h.cookies.begin() + i);
+      continue;
+    }
+    if (result.length()) result += "; ";
+    result += c.name;
+    result += '=';
+    result += c.value;
+    i++;
+  }
+  unlock();
+
+  return result;
+}
+
+String CookieJar::get(const String& host, const String& name) {
+  String value;
+  time_t now = time(nullptr);
+
+  lock();
+  Host& h = hostLocked(host);
+  for (const Cookie& c : h.cookies) {
+    if (c.name == name) {
+      if (!expired(c, now)) value = c.value;
+      break;
+    }
+  }
+  unlock();
+
+  return value;
+}
+
+void CookieJar::set(const String& host, const String& name, const String& value, time_t expire, bool limited) {
+  time_t now = time(nullptr);
+
+  lock();
+  Host& h = hostLocked(host);
+
+  for (size_t i = h.cookies.size(); i-- > 0;) {
+    if (expired(h.cookies[i], now)) h.cookies.erase(h.cookies.begin() + i);
+  }
+
+  Cookie* found = nullptr;
+  for (Cookie& c : h.cookies) {
+    if (c.name == name) {
+      found = &c;
+      break;
+    }
+  }
+
+  if (found) {
+    // 같은 값의 만료만 늦추는 갱신(api() 마다 다시 넣는 _TOKEN_ 등)은 만료가 가까울 때만 기록
+    // 기록하지 않으면 만료도 그대로 두어 RAM 과 파일이 같은 값을 가리키게 한다
+    bool extendOnly = found->value == value && found->expire != 0 && expire > found->expire;
+    if (extendOnly && found->expire - now > REFRESH_MARGIN) {
+      unlock();
+      return;
+    }
+    if (found->value != value || found->expire != expire) {
+      found->value = value;
+      found->expire = expire;
+      recordLocked(h, *found, false);
+    }
+  } else if (!limited || h.cookies.size() < MAX_COOKIES) {
+    Cookie c;
+    c.name = name;
+    c.value = value;
+    c.domain = host;
+    c.expire = expire;
+    h.cookies.push_back(c);
+    recordLocked(h, c, false);
+  }
+  unlock();
+}
+
+void CookieJar::remove(const String& host, const String& name) {
+  lock();
+  Host& h = hostLocked(host);
+  for (size_t i = 0; i < h.cookies.size(); i++) {
+    if (h.cookies[i].name == name) {
+      recordLocked(h, h.cookies[i], true);
+      h.cookies.erase(h.cookies.begin() + i);
+      Serial.printf("[HTTP] 쿠키 삭제됨: %s (%s)\n", host.c_str(), name.c_str());
+      unlock();
+      return;
+    }
+  }
+
+  // 아직 파일을 못 읽었으면(마운트 전) 파일에 있을 수 있는 같은 쿠키도 지우도록 기록
+  if (!h.loaded) {
+    Cookie c;
+    c.name = name;
+    recordLocked(h, c, true);
+  }
+  unlock();
+}
+
+void CookieJar::clear() {
+  lockFlush();
+  lock();
+  _hosts.clear();
+  bool storage = _storage;
+  unlock();
+
+  if (storage) {
+    String dirPath = "/cookies";
+    File dir = LittleFS.open(dirPath);
+    if (!dir || !dir.isDirectory()) {
+      Serial.println("[HTTP] 쿠키 디렉토리 열기 실패 또는 디렉토리 아님");
+    } else {
+      File file = dir.openNextFile();
+      while (file) {
+        String filename = file.name();
+        file.close();
+
+        if (LittleFS.remove(dirPath + "/" + filename)) {
+          Serial.printf("[HTTP] 쿠키 삭제됨: %s\n", filename.c_str());
+        } else {
+          Serial.printf("[HTTP] 쿠키 삭제 실패: %s\n", filename.c_str());
+        }
+
+        file = dir.openNextFile();
+      }
+    }
+  }
+  unlockFlush();
+
+  Serial.println("[HTTP] 모든 쿠키 삭제 완료");
+}
+
+void CookieJar::print(const String& host) {
+  time_t now = time(nullptr);
+
+  lock();
+  Host& h = hostLocked(host);
+  Serial.printf("[HTTP] 저장된 쿠키 목록 (%s):\n", h.key.c_str());
+  for (const Cookie& c : h.cookies) {
+    Serial.printf("%s %s=%s\n", expired(c, now) ? "  - 만료:" : "  - 유효:",
+                  c.name.c_str(), c.value.c_str());
+    Serial.printf("    도메인: %s, 만료: %lld\n",
+                  c.domain.length() ? c.domain.c_str() : "(없음)",
+                  (long long)c.expire);
+  }
+  unlock();
+}
+
+void CookieJar::flush() {
+  lockFlush();
+
+  // 잠금 안에서는 쓸 내용만 만들고, 파일 쓰기는 잠금 밖에서
+  std::vector<String> failed;   // 이번 저장에서 쓰기에 실패한 호스트 (다시 잡지 않음)
+  while (true) {
+    String key;
+    std::vector<uint8_t> data;
+    uint32_t records = 0;
+    bool found = false;
+    bool rewrite = false;
+    bool empty = false;
+
+    lock();
+    if (_storage) {
+      time_t now = time(nullptr);
+      for (Host& h : _hosts) {
+        if (!h.loaded || (h.pending.empty() && !h.compact)) continue;
+        if (h.failures >= MAX_FLUSH_FAILURES) continue;
+        if (std::find(failed.begin(), failed.end(), h.key) != failed.end()) continue;
+
+        // 로그가 살아 있는 쿠키의 두 배(+여유)를 넘으면 현재 쿠키만 새로 씀
+        rewrite = h.compact || h.logRecords == 0 ||
+                  h.logRecords + h.pending.size() > h.cookies.size() * 2 + 16;
+        records = 0;
+        if (rewrite) {
+          data.assign((const uint8_t*)"CKJ1", (const uint8_t*)"CKJ1" + 4);
+          for (const Cookie& c : h.cookies) {
+            if (expired(c, now)) continue;
+            Op op;
+            op.cookie = c;
+            if (appendRecord(data, op)) records++;
+          }
+          empty = (records == 0);
+        } else {
+          for (const Op& op : h.pending) {
+            if (appendRecord(data, op)) records++;
+          }
+        }
+        // 쓰는 동안 들어온 변경은 다음 저장에서 처리 (레코드 수는 쓰기가 끝난 뒤에 반영)
+        h.pending.clear();
+        h.compact = false;
+        key = h.key;
+        found = true;
+        break;
+      }
+    }
+    unlock();
+    if (!found) break;
+
+    String path = filePath(key);
+    bool ok = true;
+    if (rewrite) {
+      LittleFS.remove(legacyPath(key));
+      if (empty) {
+        ok = !LittleFS.exists(path) || LittleFS.remove(path);
+      } else {
+        // 새 파일을 다 쓴 뒤에 바꿔치기 (도중에 끊기면 이전 로그가 남음)
+        String tmp = path + ".tmp";
+        File save = LittleFS.open(tmp, "w");
+        ok = save && save.write(data.data(), data.size()) == data.size();
+        if (save) save.close();
+        if (ok) ok = LittleFS.rename(tmp, path);
+      }
+    } else if (!data.empty()) {
+      File save = LittleFS.open(path, "a");
+      ok = save && save.write(data.data(), data.size()) == data.size();
+      if (save) save.close();
+    }
+
+    bool retry = false;
+    lock();
+    for (Host& h : _hosts) {
+      if (h.key != key) continue;
+      if (!ok) {
+        // 일부만 덧붙었을 수 있으므로 다음 저장 때 RAM 의 쿠키로 파일을 새로 씀
+        h.compact = true;
+        retry = ++h.failures < MAX_FLUSH_FAILURES;
+      } else {
+        h.failures = 0;
+        if (rewrite) h.logRecords = records;
+        else h.logRecords += records;
+      }
+      break;
+    }
+    if (retry) scheduleFlushLocked();
+    unlock();
+
+    if (!ok) {
+      if (retry) {
+        Serial.printf("[HTTP] 쿠키파일 쓰기 실패 (경로: %s)\n", path.c_str());
+      } else {
+        Serial.printf("[HTTP] 쿠키파일 쓰기 %u회 실패, 다음 변경까지 저장 중단 (경로: %s)\n",
+                      (unsigned)MAX_FLUSH_FAILURES, path.c_str());
+      }
+      failed.push_back(key);
+    }
+  }
+
+  unlockFlush();
+}
+
+void CookieJar::setFlushDelay(uint32_t ms) {
+  _flushDelay = ms;
+}
+
+void CookieJar::setStorageReady(bool ready) {
+  lock();
+  _storage = ready;
+  if (ready) {
+    // 마운트 전에 RAM 에서 바뀐 호스트는 파일과 합쳐서 저장
+    bool pending = false;
+    for (Host& h : _hosts) {
+      loadLocked(h);
+      if (!h.pending.empty() || h.compact) pending = true;
+    }
+    if (pending) scheduleFlushLocked();
+  }
+  unlock();
+}
@@ -0,0 +1,95 @@
+#ifndef COOKIE_JAR_H
+#define COOKIE_JAR_H
+
+#include <Arduino.h>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+
+// 호스트별 쿠키를 RAM 에 두고 LittleFS 에는 모아서 늦게 쓰는 쿠키 저장소
+// 호스트 파일은 처음 접근할 때 한 번만 읽고, 변경은 잠잠해진 뒤(기본 3초) 또는 flush() 때 저장한다
+// 여러 HttpSecure 가 같은 파일을 쓰므로 인스턴스 하나를 공유한다
+//
+// 파일(/cookies/<host>.bin)은 "CKJ1" 뒤에 레코드를 덧붙이는 로그이다
+//   레코드: [본문 길이 2][CRC-32 4][본문]
+//   본문:   [종류 1 (1=설정, 2=삭제)][만료 8][이름 길이 1][이름][값 길이 2][값][도메인 길이 1][도메인][경로 길이 1][경로]
+// 숫자는 모두 리틀 엔디언. CRC 가 맞지 않거나 잘린 레코드부터는 버리고(쓰다 끊긴 경우) 다음 저장 때 정리한다
+// 레코드가 살아 있는 쿠키보다 많이 쌓이면 현재 쿠키만 새 파일에 쓰고 바꿔치기한다(압축)
+class CookieJar {
+public:
+  static CookieJar& instance();
+
+  String header(const String& host);   // 요청용 "a=1; b=2" (만료된 쿠키는 여기서 정리)
+  String get(const String& host, const String& name);
+  // limited 이면 호스트당 최대 개수를 넘는 새 쿠키는 버림 (서버 Set-Cookie)
+  void set(const String& host, const String& name, const String& value, time_t expire, bool limited = false);
+  void remove(const String& host, const String& name);
+  void clear();                        // 메모리와 파일 모두 삭제
+  void print(const String& host);
+
+  void flush();                        // 변경된 호스트를 지금 저장
+  void setFlushDelay(uint32_t ms);     // 마지막 변경 후 저장까지 기다리는 시간
+  void setStorageReady(bool ready);    // LittleFS 마운트 여부 (마운트 전 변경은 RAM 에만 두었다가 합침)
+
+private:
+  struct Cookie {
+    String name;
+    String value;
+    String domain;
+    String path = "/";
+    time_t expire = 0;   // UTC, 0 이면 세션 쿠키
+  };
+
+  struct Op {
+    bool remove = false;   // 삭제면 cookie.name 만 사용
+    Cookie cookie;
+  };
+
+  struct Host {
+    String key;                    // 파일 이름과 같은 규칙 (':' → '_')
+    std::vector<Cookie> cookies;
+    std::vector<Op> pending;       // 아직 로그에 덧붙이지 않은 변경
+    uint32_t logRecords = 0;       // 파일에 있는 레코드 수 (0 이면 다음 저장은 새로 씀)
+    bool loaded = false;           // 파일 내용을 합쳤는지
+    bool compact = false;          // 다음 저장 때 파일을 새로 써야 하는지 (손상/구 형식)
+    uint8_t failures = 0;          // 연속 쓰기 실패 횟수 (한도에 닿으면 다음 변경까지 저장하지 않음)
+  };
+
+  static const size_t MAX_COOKIES = 20;
+  static const size_t RECORD_HEADER = 6;   // 본문 길이 + CRC
+  static const uint8_t MAX_FLUSH_FAILURES = 3;   // 가득 찬/읽기 전용 FS 에 계속 다시 쓰지 않도록
+  static const time_t REFRESH_MARGIN = 86400 * 7;   // 만료 연장만 하는 set() 은 남은 기간이 이보다 짧을 때만 기록
+
+  std::vector<Host> _hosts;
+  SemaphoreHandle_t _lock = nullptr;
+  SemaphoreHandle_t _flushLock = nullptr;   // 같은 파일을 두 곳에서 동시에 쓰지 않도록
+  TaskHandle_t _flushTask = nullptr;
+  uint32_t _flushDelay = 3000;
+  bool _storage = false;
+
+  CookieJar() = default;
+
+  void lock();
+  void unlock();
+  void lockFlush();
+  void unlockFlush();
+
+  Host& hostLocked(const String& host);
+  void loadLocked(Host& h);
+  void loadLegacyLocked(Host& h);
+  void recordLocked(Host& h, const Cookie& c, bool remove);
+  void scheduleFlushLocked();
+  static bool expired(const Cookie& c, time_t now);
+  static String hostKey(const String& host);
+  static String filePath(const String& key);
+  static String legacyPath(const String& key);
+  static bool appendRecord(std::vector<uint8_t>& out, const Op& op);
+  static size_t parseRecords(const uint8_t* data, size_t len, std::vector<Cookie>& cookies, uint32_t& records);
+  static uint32_t crc32(const uint8_t* data, size_t len);
+  static void flushTask(void* arg);
+};
+
+#endif
@@ -0,0 +1,566 @@
+#include "HttpAsync.h"
+#include "Ethernet/EthernetESP32.h"
+
+extern "C" {
+  #include <mbedtls/error.h>
+  #include <mbedtls/net_sockets.h>
+}
+
+static const UBaseType_t QUEUE_LENGTH = 8;
+static const size_t COALESCE_BODY = 512;   // 이보다 작은 본문은 헤더와 같은 TLS 레코드로 보냄
+
+
+String HttpAsyncResponse::header(const String& name) const {
+  const char* value = headers ? headers->get(name.c_str()) : nullptr;
+  return value ? String(value) : String();
+}
+
+
+HttpAsync::HttpAsync() {
+}
+
+HttpAsync::~HttpAsync() {
+  end();
+}
+
+void HttpAsync::lock() {
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (_lock == nullptr) {
+    _lock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void HttpAsync::unlock() {
+  xSemaphoreGive(_lock);
+}
+
+bool HttpAsync::begin(uint8_t maxInFlight, uint32_t stackSize, UBaseType_t priority) {
+  if (_task) return true;
+
+  lock();
+  _maxInFlight = maxInFlight ? maxInFlight : 1;
+  if (!_queue) _queue = xQueueCreate(QUEUE_LENGTH, sizeof(Request*));
+  unlock();
+  if (!_queue) {
+    Serial.println("[HTTP] 비동기 요청 큐 생성 실패");
+    return false;
+  }
+
+  _running = true;
+  if (xTaskCreate(taskEntry, "http_async", stackSize, this, priority, &_task) != pdPASS) {
+    Serial.println("[HTTP] 비동기 네트워크 태스크 생성 실패");
+    _running = false;
+    _task = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void HttpAsync::end() {
+  // 완료 콜백(네트워크 태스크) 안에서 호출하면 안 됨
+  if (!_task) return;
+  _running = false;
+
+  // 태스크가 남은 요청을 정리할 때까지 대기
+  while (_task != nullptr) {
+    delay(10);
+  }
+}
+
+uint32_t HttpAsync::get(const String& url, HttpAsyncCallback cb) {
+  return request("GET", url, "", "", cb);
+}
+
+uint32_t HttpAsync::post(const String& url, const String& body, const String& contentType, HttpAsyncCallback cb) {
+  return request("POST", url, body, contentType, cb);
+}
+
+uint32_t HttpAsync::request(const String& method, const String& url, const String& body, const String& contentType, HttpAsyncCallback cb) {
+  if (!_running || !_queue) {
+    Serial.println("[HTTP] 비동기 엔진이 시작되지 않음 (begin() 필요)");
+    return 0;
+  }
+
+  Request* r = new Request();
+
+  // 1. URL 분리 (scheme://host[:port][/path])
+  String rest = url;
+  rest.trim();
+  String lower = rest;
+  lower.toLowerCase();
+  if (lower.startsWith("https://")) {
+    r->secure = true;
+    r->port = 443;
+    rest = rest.substring(8);
+  } else if (lower.startsWith("http://")) {
+    r->secure = false;
+    r->port = 80;
+    rest = rest.substring(7);
+  } else {
+    Serial.println("[HTTP] 지원하지 않는 프로토콜");
+    delete r;
+    return 0;
+  }
+
+  int slashIndex = rest.indexOf('/');
+  if (slashIndex == -1) slashIndex = rest.length();
+  int colonIndex = rest.indexOf(':');
+  if (colonIndex != -1 && colonIndex < slashIndex) {
+    r->host = rest.substring(0, colonIndex);
+    r->port = rest.substring(colonIndex + 1, slashIndex).toInt();
+  } else {
+    r->host = rest.substring(0, slashIndex);
+  }
+  r->path = (slashIndex < (int)rest.length()) ? rest.substring(slashIndex) : "/";
+  r->method = method;
+  r->cb = cb;
+
+  // 2. 시작줄과 헤더는 제출 시 한 번만 직렬화
+  r->head.reserve(128 + body.length());
+  r->head = method + " " + r->path + " HTTP/1.1\r\n";
+  r->head += "Host: " + r->host + "\r\n";
+
+  lock();
+  for (auto& kv : _headers) {
+    r->head += kv.first + ": " + kv.second + "\r\n";
+  }
+  r->id = _nextId++;
+  if (_nextId == 0) _nextId = 1;
+  unlock();
+
+  if (method == "POST" || method == "PUT" || body.length() > 0) {
+    r->head += "Content-Type: " + contentType + "\r\n";
+    r->head += "Content-Length: " + String(body.length()) + "\r\n";
+  }
+  r->head += "Connection: keep-alive\r\n\r\n";
+
+  // 작은 본문은 헤더 뒤에 붙여 한 번에 보내고, 큰 본문은 따로 보관해 그대로 전송
+  if (body.length() <= COALESCE_BODY) {
+    r->head += body;
+  } else {
+    r->body = body;
+  }
+
+  uint32_t id = r->id;
+  lock();
+  _pending++;
+  unlock();
+  if (xQueueSend(_queue, &r, 0) != pdTRUE) {
+    Serial.println("[HTTP] 비동기 요청 큐가 가득 참");
+    lock();
+    _pending--;
+    unlock();
+    delete r;
+    return 0;
+  }
+  return id;
+}
+
+void HttpAsync::requestHeader(const String& name, const String& value) {
+  lock();
+  for (auto& kv : _headers) {
+    if (kv.first.equalsIgnoreCase(name)) {
+      kv.second = value;
+      unlock();
+      return;
+    }
+  }
+  _headers.emplace_back(name, value);
+  unlock();
+}
+
+void HttpAsync::setTimeout(uint32_t ms) {
+  _timeout = ms;
+}
+
+void HttpAsync::setTlsConfig(std::shared_ptr<TlsConfig> config) {
+  // 진행 중인 요청이 참조하는 설정은 연결이 shared_ptr 로 붙잡고 있으므로 교체해도 안전
+  lock();
+  _tls = config;
+  unlock();
+  _pool.clear();
+}
+
+size_t HttpAsync::pending() {
+  lock();
+  size_t n = _pending;
+  unlock();
+  return n;
+}
+
+
+void HttpAsync::taskEntry(void* arg) {
+  HttpAsync* self = static_cast<HttpAsync*>(arg);
+  self->loop();
+
+  self->_task = nullptr;
+  vTaskDelete(NULL);
+}
+
+void HttpAsync::loop() {
+  while (_running) {
+    // 1. 여유가 있으면 새 요청 시작 (처리 중인 요청이 없으면 큐에서 잠시 대기)
+    TickType_t wait = _active.empty() ? pdMS_TO_TICKS(100) : 0;
+    Request* incoming;
+    while (_active.size() < _maxInFlight && xQueueReceive(_queue, &incoming, wait) == pdTRUE) {
+      start(incoming);
+      wait = 0;
+    }
+    if (_active.empty()) continue;
+
+    // 2. 모든 소켓을 한 번에 대기 (새 요청을 받을 수 있도록 짧은 타임아웃)
+    fd_set rfds, wfds;
+    FD_ZERO(&rfds);
+    FD_ZERO(&wfds);
+    int maxfd = -1;
+    for (Request* r : _active) {
+      if (r->state == FINISHED || !r->conn || r->conn->socket < 0) continue;
+      FD_SET(r->conn->socket, r->wantWrite ? &wfds : &rfds);
+      if (r->conn->socket > maxfd) maxfd = r->conn->socket;
+    }
+
+    struct timeval tv = { 0, 20000 };
+    int ready = select(maxfd + 1, &rfds, &wfds, nullptr, &tv);
+
+    // 3. 준비된 요청만 진행하고, 끝났거나 시간이 지난 요청을 정리
+    uint32_t now = millis();
+    for (size_t i = 0; i < _active.size(); ) {
+      Request* r = _active[i];
+      if (ready > 0 && r->state != FINISHED && r->conn && r->conn->socket >= 0) {
+        int fd = r->conn->socket;
+        if (FD_ISSET(fd, &rfds) || FD_ISSET(fd, &wfds)) step(r);
+      }
+      if (r->state != FINISHED && (int32_t)(now - r->deadline) >= 0) {
+        fail(r, "시간 초과");
+      }
+
+      if (r->state == FINISHED) {
+        delete r;
+        _active.erase(_active.begin() + i);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  // 종료: 처리 중이거나 대기 중인 요청은 모두 실패로 알림
+  for (Request* r : _active) {
+    if (r->state != FINISHED) fail(r, "엔진 종료");
+    delete r;
+  }
+  _active.clear();
+
+  Request* r;
+  while (xQueueReceive(_queue, &r, 0) == pdTRUE) {
+    finish(r, false);
+    delete r;
+  }
+  _pool.clear();
+}
+
+void HttpAsync::start(Request* r) {
+  r->deadline = millis() + _timeout;
+  _active.push_back(r);
+
+  // 같은 host:port:scheme 의 유휴 연결이 있으면 DNS/connect/핸드셰이크 생략
+  String key = String(r->secure ? "https://" : "http://") + r->host + ":" + String(r->port);
+  r->conn = _pool.acquire(key);
+  if (r->conn) {
+    r->reused = true;
+    r->state = SENDING;
+    r->wantWrite = true;
+    return;
+  }
+  open(r);
+}
+
+void HttpAsync::step(Request* r) {
+  // 한 번 깨어나면 WANT_READ/WANT_WRITE 로 막힐 때까지 진행
+  bool progress = true;
+  while (progress && r->state != FINISHED) {
+    switch (r->state) {
+      case CONNECTING: progress = connect(r); break;
+      case HANDSHAKE:  progress = handshake(r); break;
+      case SENDING:    progress = send(r); break;
+      case RECV_HEAD:
+      case RECV_BODY:  progress = receive(r); break;
+      default:         progress = false; break;
+    }
+  }
+}
+
+void HttpAsync::open(Request* r) {
+  // DNS 캐시에 없으면 lwIP 가 블로킹으로 질의하므로 이 동안은 다른 요청도 잠시 멈춘다
+  IPAddress ip;
+  if (!Ethernet.hostByName(r->host.c_str(), ip)) {
+    fail(r, "DNS질의 실패");
+    return;
+  }
+
+  HttpConnection* conn = new HttpConnection();
+  conn->key = String(r->secure ? "https://" : "http://") + r->host + ":" + String(r->port);
+  r->conn = conn;
+
+  conn->socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (conn->socket < 0) {
+    conn->socket = -1;
+    fail(r, "socket() 생성 실패");
+    return;
+  }
+  fcntl(conn->socket, F_SETFL, fcntl(conn->socket, F_GETFL, 0) | O_NONBLOCK);
+
+  struct sockaddr_in server;
+  server.sin_family = AF_INET;
+  server.sin_port = htons(r->port);
+  server.sin_addr.s_addr = ip;
+
+  if (::connect(conn->socket, (struct sockaddr*)&server, sizeof(server)) != 0 && errno != EINPROGRESS) {
+    Ethernet.forgetHost(r->host.c_str());
+    fail(r, "connect() 연결 실패");
+    return;
+  }
+
+  // 연결 완료는 소켓이 쓰기 가능해지는 것으로 확인
+  r->state = CONNECTING;
+  r->wantWrite = true;
+}
+
+bool HttpAsync::connect(Request* r) {
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if (getsockopt(r->conn->socket, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+    Ethernet.forgetHost(r->host.c_str());  // 캐시된 주소가 바뀌었을 수 있으므로 다음에는 다시 질의
+    fail(r, "connect() 연결 실패");
+    return false;
+  }
+
+  if (!r->secure) {
+    r->state = SENDING;
+    r->wantWrite = true;
+    return true;
+  }
+
+  // mbedTLS 설정 (공유 설정을 참조하고 연결별로는 ssl 컨텍스트만 만든다)
+  lock();
+  if (!_tls) _tls = TlsConfig::shared();
+  std::shared_ptr<TlsConfig> tls = _tls;
+  unlock();
+  if (!tls || !tls->valid()) {
+    fail(r, "TLS 설정 없음");
+    return false;
+  }
+
+  HttpConnection* conn = r->conn;
+  conn->tls = tls;
+  if (mbedtls_ssl_setup(&conn->ssl, tls->conf()) != 0) {
+    fail(r, "mbedtls_ssl_setup 실패 (메모리 부족)");
+    return false;
+  }
+  mbedtls_ssl_set_hostname(&conn->ssl, r->host.c_str());
+
+  // 논블로킹 소켓의 EAGAIN 을 mbedTLS 의 WANT_READ/WANT_WRITE 로 변환
+  mbedtls_ssl_set_bio(&conn->ssl, &conn->socket,
+                      [](void* ctx, const unsigned char* buf, size_t len) -> int {
+                        int ret = ::send(*(int*)ctx, buf, len, 0);
+                        if (ret < 0) {
+                          return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+                        }
+                        return ret;
+                      },
+                      [](void* ctx, unsigned char* buf, size_t len) -> int {
+                        int ret = ::recv(*(int*)ctx, buf, len, 0);
+                        if (ret < 0) {
+                          return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_RECV_FAILED;
+                        }
+                        return ret;
+                      },
+                      nullptr);
+
+  r->sessionOffered = _sessions.offer(conn->key, &conn->ssl);
+  r->handshakeStart = millis();
+  r->state = HANDSHAKE;
+  return true;
+}
+
+bool HttpAsync::handshake(Request* r) {
+  HttpConnection* conn = r->conn;
+  int ret = mbedtls_ssl_handshake(&conn->ssl);
+
+  if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+    r->wantWrite = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+    return false;
+  }
+  if (ret != 0) {
+    char errbuf[128];
+    mbedtls_strerror(ret, errbuf, sizeof(errbuf));
+    Serial.printf("[HTTP] mbedtls_* 실패: %s\n", errbuf);
+    if (r->sessionOffered) _sessions.remove(conn->key);
+    fail(r, "TLS 핸드셰이크 실패");
+    return false;
+  }
+
+  conn->secure = true;
+  bool resumed = _sessions.save(conn->key, &conn->ssl) && r->sessionOffered;
+  _sessions.record(resumed, millis() - r->handshakeStart);
+
+  r->state = SENDING;
+  r->wantWrite = true;
+  return true;
+}
+
+bool HttpAsync::send(Request* r) {
+  size_t headLen = r->head.length();
+  size_t total = headLen + r->body.length();
+
+  while (r->txPos < total) {
+    const uint8_t* data;
+    size_t len;
+    if (r->txPos < headLen) {
+      data = (const uint8_t*)r->head.c_str() + r->txPos;
+      len = headLen - r->txPos;
+    } else {
+      data = (const uint8_t*)r->body.c_str() + (r->txPos - headLen);
+      len = total - r->txPos;
+    }
+
+    int ret = ioSend(r, data, len);
+    if (ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) {
+      r->wantWrite = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+      return false;
+    }
+    if (ret <= 0) {
+      retry(r, "요청 전송 실패");
+      return false;
+    }
+    r->txPos += ret;
+  }
+
+  r->headers.reset();
+  r->state = RECV_HEAD;
+  r->wantWrite = false;
+  return true;
+}
+
+bool HttpAsync::receive(Request* r) {
+  uint8_t buf[512];
+
+  for (;;) {
+    int n = ioRecv(r, buf, sizeof(buf));
+    if (n == MBEDTLS_ERR_SSL_WANT_READ || n == MBEDTLS_ERR_SSL_WANT_WRITE) {
+      r->wantWrite = (n == MBEDTLS_ERR_SSL_WANT_WRITE);
+      return false;
+    }
+
+    if (n <= 0) {
+      // 재사용한 연결이 응답 전에 닫혔으면 서버가 이미 끊은 것이므로 새 연결로 한 번 재시도 (retry() 에서 메서드 확인)
+      if (r->state == RECV_HEAD) {
+        retry(r, "응답 수신 중 오류 발생");
+        return false;
+      }
+      if (n == 0 || n == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) r->decoder.finishOnClose();
+      if (r->decoder.done()) {
+        r->keepConnection = false;
+        finish(r, true);
+      } else {
+        fail(r, "응답 수신 중 오류 발생");
+      }
+      return false;
+    }
+
+    size_t pos = 0;
+    if (r->state == RECV_HEAD) {
+      pos = r->headers.feed(buf, n);
+      if (r->headers.failed()) {
+        fail(r, "응답 헤더 형식 오류");
+        return false;
+      }
+      if (!r->headers.done()) continue;
+
+      r->keepConnection = r->decoder.beginResponse(r->headers, r->method == "HEAD");
+      r->state = RECV_BODY;
+    }
+
+    while (pos < (size_t)n && !r->decoder.done() && !r->decoder.failed()) {
+      const uint8_t* data = nullptr;
+      size_t dataLen = 0;
+      pos += r->decoder.decode(buf + pos, n - pos, n, &data, &dataLen);
+      if (dataLen > 0) r->response.concat((const char*)data, dataLen);
+    }
+
+    if (r->decoder.failed()) {
+      fail(r, "응답 본문 형식 오류");
+      return false;
+    }
+    if (r->decoder.done()) {
+      // 본문 뒤에 남는 바이트가 있으면 연결 상태를 알 수 없으므로 재사용하지 않음
+      if (pos < (size_t)n) r->keepConnection = false;
+      finish(r, true);
+      return false;
+    }
+  }
+}
+
+void HttpAsync::retry(Request* r, const char* why) {
+  // 요청이 한 바이트라도 나갔으면 서버가 이미 처리했을 수 있으므로 GET/HEAD 만 다시 보냄
+  bool idempotent = (r->method == "GET" || r->method == "HEAD");
+  if (!r->reused || r->retried || (r->txPos > 0 && !idempotent)) {
+    fail(r, why);
+    return;
+  }
+
+  _pool.discard(r->conn);
+  r->conn = nullptr;
+  r->reused = false;
+  r->retried = true;
+  r->txPos = 0;
+  open(r);
+}
+
+void HttpAsync::finish(Request* r, bool ok) {
+  // 응답을 끝까지 읽은 연결은 풀에 반납하고, 나머지는 닫는다
+  if (r->conn) {
+    if (ok && r->keepConnection && r->decoder.done()) {
+      r->conn->requests++;
+      _pool.release(r->conn);
+    } else {
+      _pool.discard(r->conn);
+    }
+    r->conn = nullptr;
+  }
+  r->state = FINISHED;
+
+  HttpAsyncResponse resp;
+  resp.id = r->id;
+  resp.statusCode = ok ? r->headers.status() : -1;
+  resp.body = std::move(r->response);
+  resp.headers = ok ? &r->headers : nullptr;
+  if (r->cb) r->cb(resp);
+
+  lock();
+  _pending--;
+  unlock();
+}
+
+void HttpAsync::fail(Request* r, const char* why) {
+  Serial.printf("[HTTP] 비동기 요청 #%lu 실패: %s\n", (unsigned long)r->id, why);
+  finish(r, false);
+}
+
+int HttpAsync::ioSend(Request* r, const uint8_t* buf, size_t len) {
+  if (r->secure) {
+    return mbedtls_ssl_write(&r->conn->ssl, buf, len);
+  }
+  int ret = ::send(r->conn->socket, buf, len, 0);
+  if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return MBEDTLS_ERR_SSL_WANT_WRITE;
+  return ret;
+}
+
+int HttpAsync::ioRecv(Request* r, uint8_t* buf, size_t len) {
+  if (r->secure) {
+    return mbedtls_ssl_read(&r->conn->ssl, buf, len);
+  }
+  int ret = ::recv(r->conn->socket, buf, len, 0);
+  if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return MBEDTLS_ERR_SSL_WANT_READ;
+  return ret;
+}
@@ -0,0 +1,128 @@
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "HttpBodyDecoder.h"
+#include "HttpConnectionPool.h"
+#include "HttpHeaderParser.h"
+#include "TlsConfig.h"
+#include "TlsSessionCache.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+
+// 완료 콜백에 전달되는 응답 (콜백이 끝나면 헤더는 해제된다)
+struct HttpAsyncResponse {
+  uint32_t id = 0;
+  int statusCode = -1;    // 연결 실패, 타임아웃, 형식 오류면 -1
+  String body;
+
+  String header(const String& name) const;
+
+  const HttpHeaderParser* headers = nullptr;
+};
+
+using HttpAsyncCallback = std::function<void(HttpAsyncResponse&)>;
+
+
+// 네트워크 태스크 하나가 select() 로 여러 요청의 소켓을 번갈아 처리하는 비동기 HTTP(S) 클라이언트
+// 호출한 태스크는 요청을 큐에 넣고 바로 돌아가며, 완료 콜백은 네트워크 태스크에서 호출된다
+class HttpAsync {
+public:
+  HttpAsync();
+  ~HttpAsync();
+
+  bool begin(uint8_t maxInFlight = 2, uint32_t stackSize = 8192, UBaseType_t priority = 1);
+  void end();   // 진행 중인 요청은 모두 실패(-1) 처리
+
+  // 요청 ID 를 반환 (큐가 가득 찼거나 URL 이 잘못되면 0)
+  uint32_t get(const String& url, HttpAsyncCallback cb);
+  uint32_t post(const String& url, const String& body, const String& contentType, HttpAsyncCallback cb);
+  uint32_t request(const String& method, const String& url, const String& body, const String& contentType, HttpAsyncCallback cb);
+
+  void requestHeader(const String& name, const String& value);   // 이후 제출하는 모든 요청에 추가
+  void setTimeout(uint32_t ms);
+  void setTlsConfig(std::shared_ptr<TlsConfig> config);
+
+  size_t pending();   // 큐에 대기 중이거나 처리 중인 요청 수
+
+private:
+  enum State {
+    CONNECTING,
+    HANDSHAKE,
+    SENDING,
+    RECV_HEAD,
+    RECV_BODY,
+    FINISHED
+  };
+
+  struct Request {
+    uint32_t id = 0;
+    String method;
+    String host;
+    String path;
+    uint16_t port = 0;
+    bool secure = false;
+    String body;
+    String head;                 // 직렬화된 시작줄 + 헤더
+    HttpAsyncCallback cb;
+    uint32_t deadline = 0;
+
+    State state = CONNECTING;
+    HttpConnection* conn = nullptr;
+    bool reused = false;
+    bool retried = false;
+    bool wantWrite = false;
+    bool keepConnection = false;
+    uint32_t handshakeStart = 0;
+    bool sessionOffered = false;
+    size_t txPos = 0;            // head 와 body 를 이어서 본 위치
+
+    HttpHeaderParser headers;
+    HttpBodyDecoder decoder;
+    String response;
+  };
+
+  QueueHandle_t _queue = nullptr;
+  TaskHandle_t _task = nullptr;
+  SemaphoreHandle_t _lock = nullptr;
+  volatile bool _running = false;
+  uint8_t _maxInFlight = 2;
+  uint32_t _timeout = 10000;
+  uint32_t _nextId = 1;
+  volatile size_t _pending = 0;
+
+  std::vector<std::pair<String, String>> _headers;
+  std::shared_ptr<TlsConfig> _tls;
+  HttpConnectionPool _pool;
+  TlsSessionCache _sessions;
+  std::vector<Request*> _active;   // 네트워크 태스크만 접근
+
+  static void taskEntry(void* arg);
+  void loop();
+  void start(Request* r);
+  void step(Request* r);
+  void open(Request* r);
+  bool connect(Request* r);
+  bool handshake(Request* r);
+  bool send(Request* r);
+  bool receive(Request* r);
+  void retry(Request* r, const char* why);
+  void finish(Request* r, bool ok);
+  void fail(Request* r, const char* why);
+
+  int ioSend(Request* r, const uint8_t* buf, size_t len);
+  int ioRecv(Request* r, uint8_t* buf, size_t len);
+
+  void lock();
+  void unlock();
+};
+
+#endif
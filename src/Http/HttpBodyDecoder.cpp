@@ -0,0 +1,188 @@
+#include "HttpBodyDecoder.h"
+
+static const size_t MAX_TRAILER_LINE = 1024;
+
+
+void HttpBodyDecoder::begin(Mode mode, uint32_t contentLength) {
+  _mode = mode;
+  _chunkSize = 0;
+  _sizeDigits = false;
+  _line = "";
+  _trailers = "";
+
+  switch (mode) {
+    case IDENTITY:
+      _remaining = contentLength;
+      _state = contentLength ? DATA : DONE;
+      break;
+    case CHUNKED:
+      _remaining = 0;
+      _state = CHUNK_SIZE;
+      break;
+    case UNTIL_CLOSE:
+      _remaining = 0;
+      _state = DATA;
+      break;
+  }
+}
+
+bool HttpBodyDecoder::beginResponse(const HttpHeaderParser& headers, bool headRequest) {
+  int status = headers.status();
+  const char* transferEncoding = headers.get(HttpHeaderParser::TRANSFER_ENCODING);
+  const char* contentLength = headers.get(HttpHeaderParser::CONTENT_LENGTH);
+
+  if (headRequest || status == 204 || status == 304 || (status >= 100 && status < 200)) {
+    begin(IDENTITY, 0);
+  } else if (transferEncoding && strcasestr(transferEncoding, "chunked")) {
+    begin(CHUNKED);
+  } else if (!transferEncoding && contentLength && atol(contentLength) >= 0) {
+    begin(IDENTITY, atol(contentLength));
+  } else {
+    begin(UNTIL_CLOSE);  // 길이 정보 없음 → 서버가 연결을 닫을 때까지 읽음
+  }
+
+  // 본문 경계가 명확하고 서버가 닫겠다고 하지 않았으면 재사용 가능
+  const char* connection = headers.get(HttpHeaderParser::CONNECTION);
+  return _mode != UNTIL_CLOSE && !headers.http10() && !(connection && strcasestr(connection, "close"));
+}
+
+size_t HttpBodyDecoder::decode(const uint8_t* in, size_t len, size_t maxData, const uint8_t** data, size_t* dataLen) {
+  *data = nullptr;
+  *dataLen = 0;
+
+  size_t i = 0;
+  while (i < len && _state != DONE && _state != FAILED) {
+    uint8_t c = in[i];
+
+    switch (_state) {
+      case DATA: {
+        // 본문 구간은 한 번에 하나의 연속된 영역만 돌려준다
+        size_t n = len - i;
+        if (_mode != UNTIL_CLOSE && n > _remaining) n = _remaining;
+        if (n > maxData) n = maxData;
+        if (n == 0) return i;
+
+        *data = in + i;
+        *dataLen = n;
+        if (_mode != UNTIL_CLOSE) {
+          _remaining -= n;
+          if (_remaining == 0) endData();
+        }
+        return i + n;
+      }
+
+      case CHUNK_SIZE: {
+        int v = -1;
+        if (c >= '0' && c <= '9') v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+
+        if (v >= 0) {
+          if (_chunkSize > 0x07FFFFFF) {  // 비정상적으로 큰 청크
+            _state = FAILED;
+            break;
+          }
+          _chunkSize = (_chunkSize << 4) | v;
+          _sizeDigits = true;
+        } else if (_sizeDigits && (c == ';' || c == ' ' || c == '\t')) {
+          _state = CHUNK_EXT;
+        } else if (_sizeDigits && c == '\r') {
+          _state = CHUNK_SIZE_LF;
+        } else {
+          _state = FAILED;
+          break;
+        }
+        i++;
+        break;
+      }
+
+      case CHUNK_EXT:
+        // chunk-extension 은 사용하지 않으므로 줄 끝까지 건너뜀
+        if (c == '\r') _state = CHUNK_SIZE_LF;
+        i++;
+        break;
+
+      case CHUNK_SIZE_LF:
+        if (c != '\n') {
+          _state = FAILED;
+          break;
+        }
+        i++;
+        if (_chunkSize == 0) {
+          _state = TRAILER;  // 마지막 청크, 트레일러 또는 빈 줄이 뒤따름
+          _line = "";
+        } else {
+          _remaining = _chunkSize;
+          _state = DATA;
+        }
+        _chunkSize = 0;
+        _sizeDigits = false;
+        break;
+
+      case DATA_CR:
+        if (c != '\r') {
+          _state = FAILED;
+          break;
+        }
+        _state = DATA_LF;
+        i++;
+        break;
+
+      case DATA_LF:
+        if (c != '\n') {
+          _state = FAILED;
+          break;
+        }
+        _state = CHUNK_SIZE;
+        i++;
+        break;
+
+      case TRAILER:
+        i++;
+        if (c == '\n') {
+          if (_line.isEmpty()) {
+            _state = DONE;  // 빈 줄: 응답 끝
+          } else {
+            _trailers += _line;
+            _trailers += "\r\n";
+            _line = "";
+          }
+        } else if (c != '\r') {
+          if (_line.length() >= MAX_TRAILER_LINE) {
+            _state = FAILED;
+            break;
+          }
+          _line += (char)c;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return i;
+}
+
+size_t HttpBodyDecoder::directBytes() const {
+  if (_state != DATA) return 0;
+  if (_mode == UNTIL_CLOSE) return (size_t)-1;
+  return _remaining;
+}
+
+void HttpBodyDecoder::consumeDirect(size_t n) {
+  if (_state != DATA || _mode == UNTIL_CLOSE) return;
+  if (n > _remaining) n = _remaining;
+  _remaining -= n;
+  if (_remaining == 0) endData();
+}
+
+void HttpBodyDecoder::finishOnClose() {
+  if (_state == DONE) return;
+  // 길이 정보가 없는 본문만 연결 종료로 정상 완료된다
+  _state = (_mode == UNTIL_CLOSE) ? DONE : FAILED;
+}
+
+void HttpBodyDecoder::endData() {
+  _state = (_mode == CHUNKED) ? DATA_CR : DONE;
+}
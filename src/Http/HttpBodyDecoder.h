@@ -0,0 +1,63 @@
+#ifndef HTTP_BODY_DECODER_H
+#define HTTP_BODY_DECODER_H
+
+#include <Arduino.h>
+
+#include "HttpHeaderParser.h"
+
+
+// HTTP/1.1 응답 본문 프레이밍 상태기계 (Content-Length / chunked / 연결 종료까지)
+// 소켓 버퍼를 그대로 넘기면 본문 바이트의 위치만 알려주므로 복사가 필요 없다
+class HttpBodyDecoder {
+public:
+  enum Mode {
+    IDENTITY,      // Content-Length 만큼
+    CHUNKED,       // Transfer-Encoding: chunked
+    UNTIL_CLOSE    // 길이 정보 없음, 서버가 연결을 닫을 때까지
+  };
+
+  void begin(Mode mode, uint32_t contentLength = 0);
+
+  // 응답 헤더로 프레이밍을 정하고(RFC 7230 3.3.3), 본문을 끝까지 읽으면 연결을 재사용할 수 있는지 반환
+  bool beginResponse(const HttpHeaderParser& headers, bool headRequest);
+
+  // in[0..len) 을 해석해 소비한 바이트 수를 반환한다
+  // 본문 바이트가 있으면 *data/*dataLen 으로 위치를 알려준다 (최대 maxData 바이트)
+  size_t decode(const uint8_t* in, size_t len, size_t maxData, const uint8_t** data, size_t* dataLen);
+
+  // 구분자 없이 바로 이어지는 본문 바이트 수 (버퍼를 거치지 않고 직접 읽을 수 있는 양)
+  size_t directBytes() const;
+  void consumeDirect(size_t n);
+
+  void finishOnClose();   // 연결이 닫혔을 때 호출
+
+  bool done() const { return _state == DONE; }
+  bool failed() const { return _state == FAILED; }
+  Mode mode() const { return _mode; }
+  const String& trailers() const { return _trailers; }   // "name: value\r\n" 형태로 누적
+
+private:
+  enum State {
+    CHUNK_SIZE,
+    CHUNK_EXT,
+    CHUNK_SIZE_LF,
+    DATA,
+    DATA_CR,
+    DATA_LF,
+    TRAILER,
+    DONE,
+    FAILED
+  };
+
+  Mode _mode = IDENTITY;
+  State _state = DONE;
+  uint32_t _remaining = 0;   // 현재 데이터 구간(본문 또는 청크)에 남은 바이트
+  uint32_t _chunkSize = 0;
+  bool _sizeDigits = false;
+  String _line;              // 진행 중인 트레일러 줄
+  String _trailers;
+
+  void endData();
+};
+
+#endif
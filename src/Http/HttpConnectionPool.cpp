@@ -0,0 +1,147 @@
+#include "HttpConnectionPool.h"
+
+
+HttpConnection::HttpConnection() {
+  mbedtls_ssl_init(&ssl);
+}
+
+HttpConnection::~HttpConnection() {
+  close();
+  mbedtls_ssl_free(&ssl);
+}
+
+void HttpConnection::close() {
+  if (socket == -1) return;
+
+  if (secure) {
+    mbedtls_ssl_close_notify(&ssl);
+  }
+  ::close(socket);
+  socket = -1;
+}
+
+
+HttpConnectionPool::HttpConnectionPool() {
+}
+
+void HttpConnectionPool::lock() {
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (_lock == nullptr) {
+    _lock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void HttpConnectionPool::unlock() {
+  xSemaphoreGive(_lock);
+}
+
+HttpConnection* HttpConnectionPool::acquire(const String& key) {
+  lock();
+  uint32_t now = millis();
+  pruneLocked(now);
+
+  HttpConnection* found = nullptr;
+  // 가장 최근에 반납된 연결부터 확인 (서버 측 타임아웃에 걸렸을 가능성이 가장 낮음)
+  for (int i = (int)_idle.size() - 1; i >= 0; --i) {
+    HttpConnection* conn = _idle[i];
+    if (conn->key != key) continue;
+
+    _idle.erase(_idle.begin() + i);
+    if (isAlive(conn)) {
+      found = conn;
+      break;
+    }
+    delete conn;  // 서버가 이미 닫은 연결
+  }
+  unlock();
+
+  return found;
+}
+
+void HttpConnectionPool::release(HttpConnection* conn) {
+  if (conn == nullptr) return;
+  if (conn->socket == -1) {
+    delete conn;
+    return;
+  }
+
+  lock();
+  conn->lastUsed = millis();
+  pruneLocked(conn->lastUsed);
+
+  // 한도를 넘으면 가장 오래된 연결부터 정리 (_idle은 반납 순서대로 쌓인다)
+  uint8_t sameHost = 0;
+  for (HttpConnection* c : _idle) {
+    if (c->key == conn->key) sameHost++;
+  }
+  for (size_t i = 0; i < _idle.size() && sameHost >= _maxPerHost; ) {
+    if (_idle[i]->key != conn->key) { i++; continue; }
+    delete _idle[i];
+    _idle.erase(_idle.begin() + i);
+    sameHost--;
+  }
+  while (!_idle.empty() && _idle.size() >= _maxTotal) {
+    delete _idle.front();
+    _idle.erase(_idle.begin());
+  }
+
+  if (_maxPerHost > 0) {
+    _idle.push_back(conn);
+    conn = nullptr;
+  }
+  unlock();
+
+  if (conn) delete conn;
+}
+
+void HttpConnectionPool::discard(HttpConnection* conn) {
+  delete conn;
+}
+
+void HttpConnectionPool::clear() {
+  lock();
+  for (HttpConnection* c : _idle) delete c;
+  _idle.clear();
+  unlock();
+}
+
+void HttpConnectionPool::setIdleTimeout(uint32_t ms) {
+  _idleTimeout = ms;
+}
+
+void HttpConnectionPool::setMaxPerHost(uint8_t n) {
+  lock();
+  _maxPerHost = n;
+  if (_maxTotal < n) _maxTotal = n;
+  unlock();
+}
+
+size_t HttpConnectionPool::idleCount() {
+  lock();
+  size_t n = _idle.size();
+  unlock();
+  return n;
+}
+
+void HttpConnectionPool::pruneLocked(uint32_t now) {
+  for (size_t i = 0; i < _idle.size(); ) {
+    if (now - _idle[i]->lastUsed >= _idleTimeout) {
+      delete _idle[i];
+      _idle.erase(_idle.begin() + i);
+    } else {
+      i++;
+    }
+  }
+}
+
+bool HttpConnectionPool::isAlive(HttpConnection* conn) {
+  if (conn->socket == -1) return false;
+
+  // 0 이면 FIN. 유휴 연결에 읽지 않은 바이트가 있으면(close_notify 나 이전 응답의 잔여분) 다음 응답과
+  // 섞이므로 역시 재사용하지 않는다. 읽을 것이 없어 EWOULDBLOCK 일 때만 살아 있는 연결
+  uint8_t probe;
+  int r = recv(conn->socket, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (r >= 0) return false;
+  return (errno == EWOULDBLOCK || errno == EAGAIN);
+}
@@ -0,0 +1,62 @@
+#ifndef HTTP_CONNECTION_POOL_H
+#define HTTP_CONNECTION_POOL_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#include "TlsConfig.h"
+
+extern "C" {
+  #include <lwip/sockets.h>
+  #include <mbedtls/ssl.h>
+}
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+
+// 하나의 TCP(+TLS) 연결. begin()~end() 동안은 HttpSecure가, 그 외에는 풀이 소유한다
+struct HttpConnection {
+  String key;                // scheme://host:port
+  int socket = -1;
+  bool secure = false;
+  mbedtls_ssl_context ssl;
+  std::shared_ptr<TlsConfig> tls;   // ssl 이 참조하는 설정을 연결이 살아있는 동안 유지
+  uint32_t lastUsed = 0;     // 마지막으로 풀에 반납된 시각 (millis)
+  uint32_t requests = 0;     // 이 연결로 처리한 요청 수
+
+  HttpConnection();
+  ~HttpConnection();
+  void close();
+};
+
+
+// host:port:scheme 단위로 유휴 연결을 보관하는 keep-alive 풀
+class HttpConnectionPool {
+public:
+  HttpConnectionPool();
+
+  HttpConnection* acquire(const String& key);   // 살아있는 유휴 연결 반환, 없으면 nullptr
+  void release(HttpConnection* conn);           // 재사용 가능한 연결을 풀에 반납
+  void discard(HttpConnection* conn);           // 재사용 불가 연결 종료
+  void clear();
+
+  void setIdleTimeout(uint32_t ms);
+  void setMaxPerHost(uint8_t n);
+  size_t idleCount();
+
+private:
+  std::vector<HttpConnection*> _idle;
+  SemaphoreHandle_t _lock = nullptr;
+  uint32_t _idleTimeout = 30000;
+  uint8_t _maxPerHost = 1;
+  uint8_t _maxTotal = 2;   // TLS 연결 하나당 수십 KB의 힙을 사용하므로 작게 유지
+
+  void lock();
+  void unlock();
+  void pruneLocked(uint32_t now);
+  static bool isAlive(HttpConnection* conn);
+};
+
+#endif
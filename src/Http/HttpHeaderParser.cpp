@@ -0,0 +1,319 @@
+#include "HttpHeaderParser.h"
+
+static const char* const KNOWN_NAME[HttpHeaderParser::KNOWN_COUNT] = {
+  "content-length",
+  "transfer-encoding",
+  "connection",
+  "location",
+  "set-cookie",
+  "content-type"
+};
+
+const uint32_t HttpHeaderParser::KNOWN_HASH[KNOWN_COUNT] = {
+  hash("content-length"),
+  hash("transfer-encoding"),
+  hash("connection"),
+  hash("location"),
+  hash("set-cookie"),
+  hash("content-type")
+};
+
+static inline bool isBlank(char c) {
+  return c == ' ' || c == '\t';
+}
+
+
+void HttpHeaderParser::reset() {
+  _len = 0;
+  _lineStart = 0;
+  _scan = 0;
+  _state = STATUS;
+  _status = -1;
+  _http10 = false;
+  _count = 0;
+  _dropped = 0;
+  _skipping = false;
+  _lastDropped = false;
+  memset(_known, -1, sizeof(_known));
+}
+
+size_t HttpHeaderParser::feed(const uint8_t* data, size_t len) {
+  if (_state == DONE || _state == FAILED) return 0;
+
+  size_t used = 0;
+  while (used < len && (_state == STATUS || _state == HEADERS)) {
+    // 버퍼에 담을 수 없는 긴 줄은 복사하지 않고 줄 끝까지 건너뜀
+    if (_skipping) {
+      const uint8_t* nl = (const uint8_t*)memchr(data + used, '\n', len - used);
+      if (!nl) {
+        used = len;
+        break;
+      }
+      used = (nl - data) + 1;
+      _skipping = false;
+      continue;
+    }
+
+    // 마지막 한 바이트는 '\0' 종료용으로 남겨둔다
+    size_t n = min(len - used, BUFFER_SIZE - 1 - _len);
+    memcpy(_buf + _len, data + used, n);
+    _len += n;
+    used += n;
+
+    scanLines();
+
+    if (_state == DONE) {
+      size_t extra = _len - _lineStart;   // 헤더 블록 뒤의 바이트는 호출자에게 남김
+      used -= extra;
+      _len = _lineStart;
+      break;
+    }
+    if (_len == BUFFER_SIZE - 1) makeRoom();
+  }
+
+  if (_state == DONE && _dropped > 0) {
+    Serial.printf("[HTTP] 응답 헤더 %u개를 버림 (버퍼 %u 바이트, 최대 %u개)\n",
+                  (unsigned)_dropped, (unsigned)BUFFER_SIZE, (unsigned)MAX_HEADERS);
+  }
+  return used;
+}
+
+void HttpHeaderParser::scanLines() {
+  // 완성된 줄만 해석하고, 미완성 줄은 다음 feed 에서 이어서 검색
+  while (_state == STATUS || _state == HEADERS) {
+    const char* nl = (const char*)memchr(_buf + _scan, '\n', _len - _scan);
+    if (!nl) {
+      _scan = _len;
+      return;
+    }
+    size_t end = nl - _buf;
+    _scan = end + 1;
+    parseLine(_lineStart, end);
+    _lineStart = end + 1;
+  }
+}
+
+void HttpHeaderParser::makeRoom() {
+  // 버퍼가 찼는데 줄이 끝나지 않음
+  if (_state == STATUS) {
+    Serial.println("[HTTP] 응답 상태줄이 너무 김");
+    _state = FAILED;
+    return;
+  }
+
+  // 버퍼의 절반을 넘는 줄(거대한 쿠키 등)은 그 줄만 버림
+  size_t partial = _len - _lineStart;
+  bool freed = false;
+  if (partial <= (BUFFER_SIZE - 1) / 2) {
+    // 조회 대상(상태/본문 길이/연결/쿠키 등)이 아닌 헤더를 버리고 앞으로 당김
+    size_t w = 0;
+    uint8_t kept = 0;
+    bool lastKept = false;
+    for (uint8_t i = 0; i < _count; i++) {
+      lastKept = isKnown(i);
+      if (!lastKept) {
+        _dropped++;
+        continue;
+      }
+      Entry e = _entries[i];
+      size_t nameLen = strlen(_buf + e.name) + 1;
+      size_t valueLen = e.valueEnd - e.value;
+      memmove(_buf + w, _buf + e.name, nameLen);
+      e.name = w;
+      w += nameLen;
+      memmove(_buf + w, _buf + e.value, valueLen);
+      e.value = w;
+      e.valueEnd = w + valueLen;
+      w += valueLen;
+      _buf[w++] = '\0';
+      _entries[kept++] = e;
+    }
+    if (w < _lineStart) {
+      memmove(_buf + w, _buf + _lineStart, partial);
+      _scan = w + (_scan - _lineStart);
+      _len = w + partial;
+      _lineStart = w;
+      freed = true;
+    }
+    if (kept != _count) {
+      _lastDropped = _lastDropped || !lastKept;
+      _count = kept;
+      rebuildKnown();
+    }
+  }
+
+  if (!freed) {
+    _dropped++;
+    _len = _scan = _lineStart;
+    _skipping = true;
+    _lastDropped = true;
+  }
+}
+
+bool HttpHeaderParser::isKnown(uint8_t i) const {
+  for (uint8_t k = 0; k < KNOWN_COUNT; k++) {
+    if (is(i, (Known)k)) return true;
+  }
+  return false;
+}
+
+void HttpHeaderParser::rebuildKnown() {
+  memset(_known, -1, sizeof(_known));
+  for (uint8_t i = 0; i < _count; i++) {
+    for (uint8_t k = 0; k < KNOWN_COUNT; k++) {
+      if (is(i, (Known)k)) {
+        _known[k] = i;
+        break;
+      }
+    }
+  }
+}
+
+bool HttpHeaderParser::addLine(const char* line, size_t len) {
+  if (_state != DONE || _len + len + 1 > BUFFER_SIZE) return false;
+
+  size_t start = _len;
+  memcpy(_buf + start, line, len);
+  _buf[start + len] = '\0';
+  _len += len + 1;
+
+  parseHeader(start, start + len);
+  return true;
+}
+
+const char* HttpHeaderParser::get(Known k) const {
+  int8_t i = _known[k];
+  return (i >= 0) ? value(i) : nullptr;
+}
+
+const char* HttpHeaderParser::get(const char* name) const {
+  uint32_t h = hash(name);
+
+  // 자주 쓰는 헤더는 파싱할 때 기록해 둔 위치로 바로 반환
+  for (uint8_t k = 0; k < KNOWN_COUNT; k++) {
+    if (h == KNOWN_HASH[k] && strcasecmp(name, KNOWN_NAME[k]) == 0) {
+      return get((Known)k);
+    }
+  }
+
+  // 같은 이름이 여러 번 오면 가장 마지막 값
+  for (int i = _count - 1; i >= 0; --i) {
+    if (_entries[i].hash == h && strcasecmp(this->name(i), name) == 0) {
+      return value(i);
+    }
+  }
+  return nullptr;
+}
+
+bool HttpHeaderParser::is(uint8_t i, Known k) const {
+  return _entries[i].hash == KNOWN_HASH[k] && strcmp(name(i), KNOWN_NAME[k]) == 0;
+}
+
+void HttpHeaderParser::parseLine(size_t start, size_t end) {
+  if (end > start && _buf[end - 1] == '\r') end--;
+
+  if (_state == STATUS) {
+    parseStatus(start, end);
+    _state = HEADERS;
+  } else if (end == start) {
+    _state = DONE;   // 빈 줄: 헤더 블록 끝
+  } else if (isBlank(_buf[start]) && (_count > 0 || _lastDropped)) {
+    if (!_lastDropped) foldLine(start, end);
+  } else {
+    parseHeader(start, end);
+  }
+}
+
+void HttpHeaderParser::parseStatus(size_t start, size_t end) {
+  // "HTTP/1.1 200 OK"
+  _http10 = (end - start >= 8 && memcmp(_buf + start, "HTTP/1.0", 8) == 0);
+
+  size_t i = start;
+  while (i < end && _buf[i] != ' ') i++;
+  while (i < end && _buf[i] == ' ') i++;
+
+  int code = 0;
+  bool digits = false;
+  while (i < end && _buf[i] >= '0' && _buf[i] <= '9') {
+    code = code * 10 + (_buf[i] - '0');
+    digits = true;
+    i++;
+  }
+  _status = digits ? code : -1;
+}
+
+void HttpHeaderParser::parseHeader(size_t start, size_t end) {
+  const char* colon = (const char*)memchr(_buf + start, ':', end - start);
+  if (!colon) return;   // 형식이 잘못된 줄은 무시
+
+  size_t nameEnd = colon - _buf;
+  while (nameEnd > start && isBlank(_buf[nameEnd - 1])) nameEnd--;
+
+  // 이름은 제자리에서 소문자로 바꾸면서 해시
+  uint32_t h = 2166136261u;
+  for (size_t i = start; i < nameEnd; i++) {
+    char c = _buf[i];
+    if (c >= 'A' && c <= 'Z') c += 32;
+    _buf[i] = c;
+    h = (h ^ (uint8_t)c) * 16777619u;
+  }
+
+  size_t v = (colon - _buf) + 1;
+  while (v < end && isBlank(_buf[v])) v++;
+  size_t ve = end;
+  while (ve > v && isBlank(_buf[ve - 1])) ve--;
+
+  _buf[nameEnd] = '\0';
+  _buf[ve] = '\0';
+
+  if (_count >= MAX_HEADERS) {
+    // 개수 한도: 조회 대상 헤더(Set-Cookie 등)면 가장 앞의 일반 헤더 자리를 비우고, 아니면 이 줄을 버림
+    bool known = false;
+    for (uint8_t k = 0; k < KNOWN_COUNT && !known; k++) {
+      known = (h == KNOWN_HASH[k] && strcmp(_buf + start, KNOWN_NAME[k]) == 0);
+    }
+    uint8_t victim = 0;
+    while (known && victim < _count && isKnown(victim)) victim++;
+    _dropped++;
+    if (!known || victim == _count) {
+      _lastDropped = true;
+      return;
+    }
+    memmove(&_entries[victim], &_entries[victim + 1], (_count - victim - 1) * sizeof(Entry));
+    _count--;
+    rebuildKnown();
+  }
+  _lastDropped = false;
+
+  Entry& e = _entries[_count];
+  e.name = start;
+  e.value = v;
+  e.valueEnd = ve;
+  e.hash = h;
+
+  for (uint8_t k = 0; k < KNOWN_COUNT; k++) {
+    if (is(_count, (Known)k)) {
+      _known[k] = _count;
+      break;
+    }
+  }
+  _count++;
+}
+
+void HttpHeaderParser::foldLine(size_t start, size_t end) {
+  // obs-fold: 이어지는 줄을 이전 헤더 값 바로 뒤로 당겨 공백 하나로 잇는다
+  Entry& e = _entries[_count - 1];
+
+  size_t v = start;
+  while (v < end && isBlank(_buf[v])) v++;
+  size_t ve = end;
+  while (ve > v && isBlank(_buf[ve - 1])) ve--;
+  if (v == ve) return;
+
+  size_t at = e.valueEnd;
+  if (e.value != e.valueEnd) _buf[at++] = ' ';
+  else e.value = at;
+  memmove(_buf + at, _buf + v, ve - v);
+  e.valueEnd = at + (ve - v);
+  _buf[e.valueEnd] = '\0';
+}
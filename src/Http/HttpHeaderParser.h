@@ -0,0 +1,102 @@
+#ifndef HTTP_HEADER_PARSER_H
+#define HTTP_HEADER_PARSER_H
+
+#include <Arduino.h>
+
+// 헤더 버퍼 크기와 보관할 헤더 수 (빌드 플래그로 변경, 예: -DHTTP_HEADER_BUFFER_SIZE=4096)
+// 넘치면 요청을 실패시키지 않고 조회 대상이 아닌 헤더부터 버린다
+#ifndef HTTP_HEADER_BUFFER_SIZE
+#define HTTP_HEADER_BUFFER_SIZE 2048
+#endif
+
+#ifndef HTTP_MAX_HEADERS
+#define HTTP_MAX_HEADERS 32
+#endif
+
+
+// 응답 상태줄과 헤더 블록을 하나의 고정 버퍼에 모아 한 번만 훑는 파서
+// 각 헤더는 버퍼 안의 오프셋으로만 보관하고(이름은 소문자로, 값은 '\0' 종료) 헤더마다 할당하지 않는다
+class HttpHeaderParser {
+public:
+  // 해시를 미리 계산해 두고 O(1)로 조회하는 헤더
+  enum Known {
+    CONTENT_LENGTH,
+    TRANSFER_ENCODING,
+    CONNECTION,
+    LOCATION,
+    SET_COOKIE,
+    CONTENT_TYPE,
+    KNOWN_COUNT
+  };
+
+  static const size_t BUFFER_SIZE = HTTP_HEADER_BUFFER_SIZE;
+  static const uint8_t MAX_HEADERS = HTTP_MAX_HEADERS;
+  static_assert(BUFFER_SIZE >= 256 && BUFFER_SIZE <= 65535, "헤더 오프셋은 uint16_t");
+
+  HttpHeaderParser() { reset(); }
+  void reset();
+
+  // 수신한 바이트를 이어서 해석하고 소비한 바이트 수를 반환 (헤더 블록 뒤의 본문은 소비하지 않음)
+  // 헤더 블록이 끝나기 전에는 항상 전부 소비한다
+  size_t feed(const uint8_t* data, size_t len);
+  bool addLine(const char* line, size_t len);   // 트레일러 등 헤더 블록 이후에 추가되는 "name: value" 한 줄
+
+  bool done() const { return _state == DONE; }
+  bool failed() const { return _state == FAILED; }
+
+  int status() const { return _status; }
+  bool http10() const { return _http10; }
+
+  const char* get(Known k) const;           // 마지막 값, 없으면 nullptr
+  const char* get(const char* name) const;  // 대소문자 무시, 마지막 값
+
+  uint8_t count() const { return _count; }
+  uint16_t dropped() const { return _dropped; }   // 버퍼/개수 한도 때문에 버린 헤더 수
+  const char* name(uint8_t i) const { return _buf + _entries[i].name; }
+  const char* value(uint8_t i) const { return _buf + _entries[i].value; }
+  bool is(uint8_t i, Known k) const;
+
+  static constexpr uint32_t hash(const char* s, uint32_t h = 2166136261u) {
+    // 소문자 기준 FNV-1a
+    return *s ? hash(s + 1, (h ^ (uint8_t)((*s >= 'A' && *s <= 'Z') ? *s + 32 : *s)) * 16777619u) : h;
+  }
+
+private:
+  enum State { STATUS, HEADERS, DONE, FAILED };
+
+  struct Entry {
+    uint16_t name;
+    uint16_t value;
+    uint16_t valueEnd;
+    uint32_t hash;
+  };
+
+  static const uint32_t KNOWN_HASH[KNOWN_COUNT];
+
+  char _buf[BUFFER_SIZE];
+  size_t _len = 0;        // 버퍼에 모인 바이트
+  size_t _lineStart = 0;  // 해석 중인 줄의 시작
+  size_t _scan = 0;       // '\n' 검색을 이어갈 위치
+  State _state = STATUS;
+
+  int _status = -1;
+  bool _http10 = false;
+
+  Entry _entries[MAX_HEADERS];
+  uint8_t _count = 0;
+  int8_t _known[KNOWN_COUNT];
+  uint16_t _dropped = 0;
+  bool _skipping = false;      // 버퍼보다 긴 줄을 줄 끝까지 버리는 중
+  bool _lastDropped = false;   // 직전 헤더를 버렸으면 이어지는 접힌 줄(obs-fold)도 버림
+
+  void scanLines();
+  void makeRoom();
+  bool isKnown(uint8_t i) const;
+  void rebuildKnown();
+  void parseLine(size_t start, size_t end);
+  void parseStatus(size_t start, size_t end);
+  void parseHeader(size_t start, size_t end);
+  void foldLine(size_t start, size_t end);
+};
+
+#endif
@@ -18,13 +18,12 @@
 #include <LittleFS.h>
 #include <esp_log.h>
 
-#include <mbedtls/base64.h>
+#include "Codec.h"
+#include "CookieJar.h"
+#include "WsMask.h"
 
-HttpSecure::HttpSecure() {
+HttpSecure::HttpSecure() : _bodyStream(this) {
   
-  mbedtls_ssl_init(&_ssl);
-  mbedtls_ssl_config_init(&_conf);
-  mbedtls_ctr_drbg_init(&_ctr_drbg);
   setlocale(LC_TIME, "C"); 
 
 }
@@ -34,46 +33,53 @@ bool HttpSecure::connected() {
 }
 
 
-void HttpSecure::littleFSTask(void* params) {
-  LittleFSTaskParams* taskParams = (LittleFSTaskParams*)params;
-  
+bool HttpSecure::mountLittleFS(bool formatOnFail) {
   // 마운트 시도
   if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
+    if (!formatOnFail) return false;
     Serial.println("[HTTP] LittleFS/cookies 마운트 실패! 저장소를 포맷합니다");
 
     // 포맷 시도
-    if (LittleFS.format()) {
-      // 포맷 후 다시 마운트 시도
-      if (!LittleFS.begin(true, "/spiffs", 10, "spiffs")) {
-        Serial.println("[HTTP] LittleFS/cookies 포맷 후 마운트 실패!");
-        *(taskParams->pSuccess) = false;
-        vTaskDelete(NULL);
-        return;
-      }
-      Serial.println("[HTTP] 쿠키저장소(LittleFS) 초기화 완료 : ");
-    
-      // 파일 시스템 정보 출력
-      Serial.printf("  Total space: %d bytes\n", LittleFS.totalBytes());
-      Serial.printf("  Used space: %d bytes\n", LittleFS.usedBytes());
-
-    } else {
+    if (!LittleFS.format()) {
       Serial.println("[HTTP] LittleFS/cookies 포맷 실패!");
-      *(taskParams->pSuccess) = false;
-      vTaskDelete(NULL);
-      return;
+      return false;
     }
+    // 포맷 후 다시 마운트 시도
+    if (!LittleFS.begin(true, "/spiffs", 10, "spiffs")) {
+      Serial.println("[HTTP] LittleFS/cookies 포맷 후 마운트 실패!");
+      return false;
+    }
+    Serial.println("[HTTP] 쿠키저장소(LittleFS) 초기화 완료 : ");
+
+    // 파일 시스템 정보 출력
+    Serial.printf("  Total space: %d bytes\n", LittleFS.totalBytes());
+    Serial.printf("  Used space: %d bytes\n", LittleFS.usedBytes());
   }
 
   // 디렉토리 생성 확인
-  if (!LittleFS.open("/cookies", "r")) {
+  if (!LittleFS.exists("/cookies")) {
     if (!LittleFS.mkdir("/cookies")) {
       Serial.println("[HTTP] LittleFS/cookies 디렉토리 생성 실패");
       // 실패해도 계속 진행 (파일은 직접 생성 시도)
     }
   }
+  return true;
+}
+
+void HttpSecure::littleFSTask(void* params) {
+  HttpSecure* self = static_cast<HttpSecure*>(params);
+
+  if (!mountLittleFS(true)) {
+    self->_littlefsSuccess = false;
+    xSemaphoreGive(self->_littlefsReady);
+    vTaskDelete(NULL);
+    return;
+  }
 
-  *(taskParams->pInitialized) = true;
-  *(taskParams->pSuccess) = true;
+  self->_littlefsInitialized = true;
+  self->_littlefsSuccess = true;
+  CookieJar::instance().setStorageReady(true);
+  xSemaphoreGive(self->_littlefsReady);
   
   vTaskDelete(NULL);
 }
@@ -83,25 +89,25 @@ void HttpSecure::websocketRecvTask(void* arg) {
   HttpSecure* self = static_cast<HttpSecure*>(arg);
 
   while (self->_connected) {
-    self->readFrame();
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    // 소켓에 읽을 데이터가 생기거나 end() 가 깨울 때까지 잠듦 (폴링 없음)
+    if (!self->waitReadable()) continue;
+
+    // 한 번 깨어나면 이미 받아둔 프레임을 모두 처리
+    do {
+      self->readFrame();
+    } while (self->_connected && self->rxBuffered());
   }
 
+  self->stopTxTask();
+
   // 중복 호출 방지
   if (self->_isWebSocket) {
     self->_isWebSocket = false;
 
-    if (self->_isSecure) {
-      mbedtls_ssl_close_notify(&self->_ssl);
-      mbedtls_ssl_free(&self->_ssl);
-      mbedtls_ssl_config_free(&self->_conf);
-      mbedtls_ctr_drbg_free(&self->_ctr_drbg);
-    }
-
-    // 소켓 닫기
-    if (self->_socket != -1) {
-      close(self->_socket);
-      self->_socket = -1;
+    // 업그레이드된 연결은 풀에 반납하지 않고 닫는다
+    if (self->_conn) {
+      self->_pool.discard(self->_conn);
+      self->_conn = nullptr;
     }
 
     // 연결 끊김 콜백 호출
@@ -159,6 +165,76 @@ void HttpSecure::websocketRecvTask(void* arg) {
 
 
 
+bool HttpSecure::openWakeSocket() {
+  if (_wakeSock >= 0) return true;
+
+  // lwIP 에는 pipe 가 없으므로 127.0.0.1 로 자기 자신에게 보내는 UDP 소켓을 사용
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) return false;
+
+  memset(&_wakeAddr, 0, sizeof(_wakeAddr));
+  _wakeAddr.sin_family = AF_INET;
+  _wakeAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  _wakeAddr.sin_port = 0;   // 임의 포트
+
+  socklen_t len = sizeof(_wakeAddr);
+  if (bind(sock, (struct sockaddr*)&_wakeAddr, sizeof(_wakeAddr)) != 0 ||
+      getsockname(sock, (struct sockaddr*)&_wakeAddr, &len) != 0) {
+    close(sock);
+    return false;
+  }
+  fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+  _wakeSock = sock;
+  return true;
+}
+
+void HttpSecure::wakeRecvTask() {
+  if (_wakeSock < 0) return;
+  uint8_t b = 1;
+  sendto(_wakeSock, &b, 1, 0, (struct sockaddr*)&_wakeAddr, sizeof(_wakeAddr));
+}
+
+bool HttpSecure::rxBuffered() {
+  // 수신 버퍼나 mbedTLS 내부에 복호화된 바이트가 남아 있으면 select() 없이 바로 읽을 수 있음
+  if (_rxPos < _rxLen) return true;
+  return _isSecure && _conn && mbedtls_ssl_get_bytes_avail(&_conn->ssl) > 0;
+}
+
+bool HttpSecure::waitReadable() {
+  if (rxBuffered()) return true;
+  if (!_conn || _conn->socket < 0) {
+    _connected = false;
+    return false;
+  }
+
+  int sock = _conn->socket;
+  fd_set rfds;
+  FD_ZERO(&rfds);
+  FD_SET(sock, &rfds);
+  int maxfd = sock;
+  if (_wakeSock >= 0) {
+    FD_SET(_wakeSock, &rfds);
+    if (_wakeSock > maxfd) maxfd = _wakeSock;
+  }
+
+  // 깨우기 신호를 놓치더라도 주기적으로 연결 상태를 다시 확인
+  struct timeval tv = { 5, 0 };
+  int n = select(maxfd + 1, &rfds, nullptr, nullptr, &tv);
+  if (n < 0) {
+    _connected = false;
+    return false;
+  }
+  if (n == 0) return false;
+
+  if (_wakeSock >= 0 && FD_ISSET(_wakeSock, &rfds)) {
+    uint8_t drain[8];
+    while (recv(_wakeSock, drain, sizeof(drain), 0) > 0) {}
+  }
+  return FD_ISSET(sock, &rfds);
+}
+
+
 bool HttpSecure::begin(const char* fullUrl) {
 
   String url = fullUrl;
@@ -170,16 +246,13 @@ bool HttpSecure::begin(const char* fullUrl) {
 
   // LittleFS 초기화가 아직 시작되지 않았을 때만 태스크 생성
   if (!_littlefsInitialized && _littlefsTask == NULL) {
-    LittleFSTaskParams params = {
-      .pInitialized = &_littlefsInitialized,
-      .pSuccess = &_littlefsSuccess
-    };
+    _littlefsReady = xSemaphoreCreateBinary();
 
     xTaskCreate(
       littleFSTask,      // 태스크 함수
       "littlefs_task",   // 태스크 이름
       4096,             // 스택 크기 (ESP32는 최소 3KB 권장)
-      &params,           // 파라미터
+      this,              // 파라미터
       1,                // 우선순위 (낮음)
       &_littlefsTask     // 태스크 핸들 저장
     );
@@ -223,18 +296,60 @@ bool HttpSecure::begin(const char* fullUrl) {
   _path = (slashIndex < url.length()) ? url.substring(slashIndex) : "/";
 
 
-  // 3. DNS → IP
+  // 3. 같은 host:port:scheme 의 유휴 연결이 있으면 DNS/connect/핸드셰이크 생략
+  if (_conn) {
+    _pool.discard(_conn);  // 이전 요청에서 정리되지 않은 연결
+    _conn = nullptr;
+  }
+  _reusable = false;
+  _bodyDone = true;
+  _rxPos = _rxLen = 0;
+  _conn = _pool.acquire(poolKey());
+  _reused = (_conn != nullptr);
+
+  if (!_conn) {
+    _conn = openConnection();
+    if (!_conn) return false;
+  }
+
+  // 마운트 태스크가 끝날 때까지 폴링 없이 대기 (실패하면 쿠키 기능만 꺼진 채 진행)
+  if (_littlefsReady) {
+    xSemaphoreTake(_littlefsReady, portMAX_DELAY);
+    vSemaphoreDelete(_littlefsReady);
+    _littlefsReady = nullptr;
+  }
+
+
+  if (_onConnected) {
+    _onConnected();
+  }
+  
+  _connected = true;
+  return true;
+}
+
+String HttpSecure::poolKey() {
+  return String(_isSecure ? "https://" : "http://") + _host + ":" + String(_port);
+}
+
+HttpConnection* HttpSecure::openConnection() {
+
+  // 1. DNS → IP
   IPAddress ip;
   if (!Ethernet.hostByName(_host.c_str(), ip)) {
     Serial.println("[HTTP] DNS질의 실패");
-    return false;
+    return nullptr;
   }
 
-  // 4. 소켓 연결
-  _socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (_socket < 0) {
+  // 2. 소켓 연결
+  HttpConnection* conn = new HttpConnection();
+  conn->key = poolKey();
+  conn->socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (conn->socket < 0) {
     Serial.println("[HTTP] socket() 생성 실패");
-    return false;
+    conn->socket = -1;
+    delete conn;
+    return nullptr;
   }
 
   struct sockaddr_in server;
@@ -242,35 +357,30 @@ bool HttpSecure::begin(const char* fullUrl) {
   server.sin_port = htons(_port);
   server.sin_addr.s_addr = ip;
 
-  if (connect(_socket, (struct sockaddr*)&server, sizeof(server)) != 0) {
+  if (connect(conn->socket, (struct sockaddr*)&server, sizeof(server)) != 0) {
     Serial.println("[HTTP] connect() 연결 실패");
-    close(_socket);
-    return false;
+    Ethernet.forgetHost(_host.c_str());  // 캐시된 주소가 바뀌었을 수 있으므로 다음에는 다시 질의
+    delete conn;
+    return nullptr;
   }
 
-  // 5. mbedTLS 설정
+  // 3. mbedTLS 설정 (공유 설정을 참조하고 연결별로는 ssl 컨텍스트만 만든다)
   if (_isSecure) {
-    const char* pers = "carmeleon_https";
-    mbedtls_ctr_drbg_seed(&_ctr_drbg,
-                          [](void*, unsigned char* output, size_t len) {
-                            for (size_t i = 0; i < len; ++i) output[i] = esp_random() & 0xFF;
-                            return 0;
-                          },
-                          nullptr,
-                          (const unsigned char*)pers,
-                          strlen(pers));
-
-    mbedtls_ssl_config_defaults(&_conf,
-                                MBEDTLS_SSL_IS_CLIENT,
-                                MBEDTLS_SSL_TRANSPORT_STREAM,
-                                MBEDTLS_SSL_PRESET_DEFAULT);
-
-    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);  // 인증서 무시
-    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_ctr_drbg);
-
-    mbedtls_ssl_setup(&_ssl, &_conf);
-    mbedtls_ssl_set_hostname(&_ssl, _host.c_str());
-    mbedtls_ssl_set_bio(&_ssl, &_socket,
+    if (!_tls) _tls = TlsConfig::shared();
+    if (!_tls || !_tls->valid()) {
+      Serial.println("[HTTP] TLS 설정 없음");
+      delete conn;
+      return nullptr;
+    }
+    conn->tls = _tls;
+
+    if (mbedtls_ssl_setup(&conn->ssl, _tls->conf()) != 0) {
+      Serial.println("[HTTP] mbedtls_ssl_setup 실패 (메모리 부족)");
+      delete conn;
+      return nullptr;
+    }
+    mbedtls_ssl_set_hostname(&conn->ssl, _host.c_str());
+    mbedtls_ssl_set_bio(&conn->ssl, &conn->socket,
                         [](void* ctx, const unsigned char* buf, size_t len) {
                           return send(*(int*)ctx, buf, len, 0);
                         },
@@ -279,30 +389,28 @@ bool HttpSecure::begin(const char* fullUrl) {
                         },
                         nullptr);
 
-    // 6. SSL 핸드셰이크
+    // 4. SSL 핸드셰이크 (캐시된 세션이 있으면 세션 ID/티켓으로 재개)
+    bool offered = _sessions.offer(conn->key, &conn->ssl);
+    uint32_t started = millis();
+
     int ret;
-    while ((ret = mbedtls_ssl_handshake(&_ssl)) != 0) {
+    while ((ret = mbedtls_ssl_handshake(&conn->ssl)) != 0) {
       if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
         char errbuf[128];
         mbedtls_strerror(ret, errbuf, sizeof(errbuf));
         Serial.printf("[HTTP] mbedtls_* 실패: %s\n", errbuf);
-        close(_socket);
-        return false;
+        if (offered) _sessions.remove(conn->key);
+        delete conn;
+        return nullptr;
       }
     }
-  }
+    conn->secure = true;
 
-  while (!_littlefsInitialized) {
-    delay(10); // 또는 vTaskDelay()
+    bool resumed = _sessions.save(conn->key, &conn->ssl) && offered;
+    _sessions.record(resumed, millis() - started);
   }
 
-
-  if (_onConnected) {
-    _onConnected();
-  }
-  
-  _connected = true;
-  return true;
+  return conn;
 }
 
 void HttpSecure::KeepAlive(bool enabled) {
@@ -315,26 +423,41 @@ bool HttpSecure::handshake() {
 
   uint8_t randomKey[16];
   esp_fill_random(randomKey, sizeof(randomKey));
-  size_t encodedLen;
-  uint8_t encodedBuf[32]; // 16바이트 → Base64 (24바이트 + 널 종료)
-  mbedtls_base64_encode(encodedBuf, sizeof(encodedBuf), &encodedLen, 
-                       randomKey, sizeof(randomKey));
+  char encodedBuf[32]; // 16바이트 → Base64 (24바이트 + 널 종료)
+  Codec::base64Encode(randomKey, sizeof(randomKey), encodedBuf);
 
-  String key = String((char*)encodedBuf);
+  String key = String(encodedBuf);
 
   requestHeader("Upgrade", "websocket");
   requestHeader("Connection", "Upgrade");
   requestHeader("Sec-WebSocket-Key", key);
   requestHeader("Sec-WebSocket-Version", "13");
 
+  // permessage-deflate 제안 (송신은 항상 메시지마다 새로 압축하므로 client_no_context_takeover)
+  if (_wsDeflateWanted) {
+    String offer = "permessage-deflate; client_no_context_takeover; client_max_window_bits=" + String(_wsDeflateBits)
+                 + "; server_max_window_bits=" + String(_wsDeflateBits);
+    if (_wsServerNoContext) offer += "; server_no_context_takeover";
+    requestHeader("Sec-WebSocket-Extensions", offer);
+  } else {
+    _headers.erase("Sec-WebSocket-Extensions");
+  }
+
   int status = get();
   if (status == 101) {
     _connected = true;
+    negotiateCompression();
+    _wsOpcode = 0;
+    _wsStreaming = false;
+    _wsDiscarding = false;
+    _wsMessage.clear();
 
     if (_onHandshake) {
       _onHandshake();
     }
 
+    openWakeSocket();
+    startTxTask();
     if (_wsRecvTask == nullptr) {
       xTaskCreate(
         websocketRecvTask,
@@ -355,178 +478,589 @@ bool HttpSecure::handshake() {
 
 
 
-void HttpSecure::sendMsgString(const String& message) {
-  if (!_connected) return;
-  sendFrame(message);
+bool HttpSecure::sendMsgString(const String& message) {
+  if (!_connected) return false;
+  return sendFrame(message);
 }
 
-void HttpSecure::sendMsgBinary(const std::vector<uint8_t>& data) {
-  if (!_connected) return;
+bool HttpSecure::sendMsgBinary(const std::vector<uint8_t>& data) {
+  if (!_connected) return false;
+  return sendWsMessage(0x2, data.data(), data.size());
+}
 
-  uint8_t header[10];
-  size_t len = data.size();
-  size_t offset = 2;
+void HttpSecure::setTxQueue(uint8_t maxFrames, WsTxPolicy policy, uint32_t blockTimeoutMs) {
+  wsTxLock();
+  _wsTxMax = maxFrames > 0 ? maxFrames : 1;
+  _wsTxPolicy = policy;
+  _wsTxTimeout = blockTimeoutMs;
+  wsTxUnlock();
+}
 
-  header[0] = 0x82;  // FIN + opcode 0x2 (binary)
-  if (len <= 125) {
-    header[1] = len;
-  } else if (len <= 65535) {
-    header[1] = 126;
-    header[2] = (len >> 8) & 0xFF;
-    header[3] = len & 0xFF;
-    offset = 4;
-  } else {
-    header[1] = 127;
-    // 64bit 길이는 생략 (필요시 추가 구현)
-    return;
-  }
 
-  _write(header, offset);
-  _write(data.data(), len);
+bool HttpSecure::sendFrame(const String& message) {
+  return sendWsMessage(0x1, (const uint8_t*)message.c_str(), message.length());
 }
 
+bool HttpSecure::sendWsMessage(uint8_t opcode, const uint8_t* data, size_t len) {
+  // 너무 작은 메시지는 압축해도 줄지 않으므로 그대로 보냄
+  static const size_t WS_DEFLATE_MIN = 32;
+  if (!_wsDeflateOn) return sendWsFrame(opcode, data, len);
+
+  if (len >= WS_DEFLATE_MIN) {
+    std::vector<uint8_t> packed;
+    wsTxLock();
+    uint32_t start = micros();
+    _deflater.deflate(data, len, packed);
+    _wsDeflateStats.deflateUs += micros() - start;
+    bool smaller = packed.size() < len;
+    if (smaller) {
+      _wsDeflateStats.txMessages++;
+      _wsDeflateStats.txRawBytes += len;
+      _wsDeflateStats.txWireBytes += packed.size();
+    } else {
+      _wsDeflateStats.txSkipped++;
+    }
+    wsTxUnlock();
+
+    if (smaller) return sendWsFrame(opcode, packed.data(), packed.size(), true);
+  } else {
+    wsTxLock();
+    _wsDeflateStats.txSkipped++;
+    wsTxUnlock();
+  }
+  return sendWsFrame(opcode, data, len);
+}
 
-void HttpSecure::sendFrame(const String& message) {
-  uint8_t header[10];
-  size_t len = message.length();
+bool HttpSecure::sendWsFrame(uint8_t opcode, const uint8_t* data, size_t len, bool compressed) {
+  // 클라이언트 프레임은 반드시 마스킹 (RFC 6455 5.1)
+  uint8_t header[14];
   size_t offset = 2;
 
-  header[0] = 0x81; // FIN + text frame
+  header[0] = 0x80 | (compressed ? 0x40 : 0) | opcode;  // FIN (+ RSV1: permessage-deflate)
   if (len <= 125) {
-    header[1] = len;
+    header[1] = 0x80 | len;
   } else if (len <= 65535) {
-    header[1] = 126;
+    header[1] = 0x80 | 126;
     header[2] = (len >> 8) & 0xFF;
     header[3] = len & 0xFF;
     offset = 4;
   } else {
-    header[1] = 127;
-    // 64bit length not handled for simplicity
+    header[1] = 0x80 | 127;
+    uint64_t l = len;
+    for (int k = 7; k >= 0; k--) {
+      header[2 + k] = l & 0xFF;
+      l >>= 8;
+    }
+    offset = 10;
+  }
+
+  uint8_t* mask = header + offset;
+  esp_fill_random(mask, 4);
+  offset += 4;
+
+  // 헤더와 마스킹한 페이로드를 한 프레임 버퍼로 만들어 송신 큐에 넣음 (원본 데이터는 건드리지 않음)
+  std::vector<uint8_t> frame(offset + len);
+  memcpy(frame.data(), header, offset);
+  if (len > 0) {
+    memcpy(frame.data() + offset, data, len);
+    wsMask(frame.data() + offset, len, mask, 0);
   }
 
-  _write(header, offset);
-  _write((const uint8_t*)message.c_str(), len);
+  // close 프레임은 정책과 관계없이 앞의 프레임 뒤에 반드시 들어가야 함
+  return wsEnqueue(frame, opcode == 0x8 ? TX_BLOCK : _wsTxPolicy);
 }
 
-void HttpSecure::readFrame() {
-  if (!_connected) return;
 
-  uint8_t hdr[2];
-  int hdrLen = _read(hdr, 2);
-  if (hdrLen <= 0) {
+// Sec-WebSocket-Extensions 응답에서 매개변수 값 (없으면 -1, 값 없이 있으면 0)
+static int extensionParam(const String& ext, const char* name) {
+  int pos = ext.indexOf(name);
+  if (pos < 0) return -1;
+  pos += strlen(name);
+  while (pos < (int)ext.length() && ext[pos] == ' ') pos++;
+  if (pos >= (int)ext.length() || ext[pos] != '=') return 0;
+  pos++;
+  while (pos < (int)ext.length() && (ext[pos] == ' ' || ext[pos] == '"')) pos++;
+  return atoi(ext.c_str() + pos);
+}
+
+void HttpSecure::negotiateCompression() {
+  String ext = responseHeader("Sec-WebSocket-Extensions");
+  ext.toLowerCase();
+  _wsDeflateOn = _wsDeflateWanted && ext.indexOf("permessage-deflate") >= 0;
+  _wsCompressed = false;
+
+  if (!_wsDeflateOn) {
+    _deflater.release();
+    _inflater.release();
+    return;
+  }
+
+  // 서버가 윈도우를 밝히지 않으면 최대(15)로 가정해야 함
+  int serverBits = extensionParam(ext, "server_max_window_bits");
+  int clientBits = extensionParam(ext, "client_max_window_bits");
+  if (serverBits <= 0) serverBits = 15;
+  if (clientBits <= 0 || clientBits > _wsDeflateBits) clientBits = _wsDeflateBits;
+  _wsInflateReset = extensionParam(ext, "server_no_context_takeover") >= 0;
+
+  wsTxLock();
+  _deflater.setWindowBits(clientBits);
+  wsTxUnlock();
+
+  if (!_inflater.begin(serverBits)) {
+    Serial.println("[HTTP] permessage-deflate 윈도우 할당 실패");
     _connected = false;
     return;
   }
+  Serial.printf("[HTTP] permessage-deflate 사용 (server %d bits%s, client %d bits)\n",
+                serverBits, _wsInflateReset ? ", no_context_takeover" : "", clientBits);
+}
+
+void HttpSecure::setCompression(bool enabled, uint8_t windowBits, bool serverNoContextTakeover) {
+  if (windowBits < 8) windowBits = 8;
+  if (windowBits > 15) windowBits = 15;
+  _wsDeflateWanted = enabled;
+  _wsDeflateBits = windowBits;
+  _wsServerNoContext = serverNoContextTakeover;
+}
 
-  uint8_t opcode = hdr[0] & 0x0F;
-  bool isMasked = hdr[1] & 0x80;
-  uint64_t payloadLen = hdr[1] & 0x7F;
+bool HttpSecure::compressionActive() {
+  return _wsDeflateOn;
+}
 
-  // 확장 길이 처리
-  if (payloadLen == 126) {
-    uint8_t ext[2];
-    if (_read(ext, 2) != 2) { end(); return; }
-    payloadLen = (ext[0] << 8) | ext[1];
-  } else if (payloadLen == 127) {
-    uint8_t ext[8];
-    if (_read(ext, 8) != 8) { end(); return; }
-    payloadLen = 0;
-    for (int i = 0; i < 8; ++i) {
-      payloadLen = (payloadLen << 8) | ext[i];
+WsDeflateStats HttpSecure::compressionStats() {
+  wsTxLock();
+  WsDeflateStats s = _wsDeflateStats;
+  wsTxUnlock();
+  return s;
+}
+
+void HttpSecure::printCompressionStats() {
+  WsDeflateStats s = compressionStats();
+  Serial.println("[HTTP] permessage-deflate 통계 : ");
+  Serial.printf("  송신: %u개, %u → %u bytes (%u%%), 압축 생략 %u개, %u us\n",
+                (unsigned)s.txMessages, (unsigned)s.txRawBytes, (unsigned)s.txWireBytes,
+                (unsigned)(s.txRawBytes ? (uint64_t)s.txWireBytes * 100 / s.txRawBytes : 0),
+                (unsigned)s.txSkipped, (unsigned)s.deflateUs);
+  Serial.printf("  수신: %u개, %u → %u bytes (%u%%), %u us\n",
+                (unsigned)s.rxMessages, (unsigned)s.rxWireBytes, (unsigned)s.rxRawBytes,
+                (unsigned)(s.rxRawBytes ? (uint64_t)s.rxWireBytes * 100 / s.rxRawBytes : 0),
+                (unsigned)s.inflateUs);
+}
+
+void HttpSecure::wsTxLock() {
+  if (_wsTxLock == nullptr) {
+    _wsTxLock = xSemaphoreCreateMutex();
+    _wsTxSpace = xSemaphoreCreateBinary();
+  }
+  xSemaphoreTake(_wsTxLock, portMAX_DELAY);
+}
+
+void HttpSecure::wsTxUnlock() {
+  xSemaphoreGive(_wsTxLock);
+}
+
+bool HttpSecure::wsEnqueue(std::vector<uint8_t>& frame, WsTxPolicy policy) {
+  uint32_t deadline = millis() + _wsTxTimeout;
+
+  wsTxLock();
+  while (_wsTxQueue.size() >= _wsTxMax) {
+    if (policy == TX_DROP_OLDEST) {
+      _wsTxQueue.pop_front();
+      continue;
+    }
+    if (policy == TX_FAIL || !_connected || (int32_t)(deadline - millis()) <= 0) {
+      wsTxUnlock();
+      Serial.println("[HTTP] 웹소켓 송신 큐가 가득 차 프레임을 보내지 못함");
+      return false;
+    }
+    // 송신 태스크가 프레임을 꺼내면 깨어남 (여러 태스크가 대기 중일 수 있어 짧게 나눠 기다림)
+    wsTxUnlock();
+    xSemaphoreTake(_wsTxSpace, pdMS_TO_TICKS(20));
+    wsTxLock();
+  }
+
+  _wsTxQueue.push_back(std::move(frame));
+  if (_wsTxTask) xTaskNotifyGive(_wsTxTask);
+  wsTxUnlock();
+  return true;
+}
+
+void HttpSecure::wsFlushQueue() {
+  // 작은 프레임은 최대 WS_TX_BATCH 바이트까지 이어 붙여 TLS 레코드 하나(TCP 세그먼트 하나)로 보냄
+  static const size_t WS_TX_BATCH = 1400;
+  std::vector<uint8_t> large;
+
+  while (true) {
+    wsTxLock();
+    if (_wsTxQueue.empty()) {
+      wsTxUnlock();
+      return;
+    }
+
+    _wsTx.clear();
+    if (_wsTxQueue.front().size() >= WS_TX_BATCH) {
+      large = std::move(_wsTxQueue.front());
+      _wsTxQueue.pop_front();
+    } else {
+      while (!_wsTxQueue.empty() && _wsTx.size() + _wsTxQueue.front().size() <= WS_TX_BATCH) {
+        const std::vector<uint8_t>& f = _wsTxQueue.front();
+        _wsTx.insert(_wsTx.end(), f.begin(), f.end());
+        _wsTxQueue.pop_front();
+      }
+    }
+    _wsTxBusy = true;
+    wsTxUnlock();
+    xSemaphoreGive(_wsTxSpace);
+
+    // 실패하면 _write 가 연결 플래그를 내리고, 남은 프레임은 다음 반복에서 바로 버려짐
+    if (!large.empty()) {
+      _write(large.data(), large.size());
+      large.clear();
+      large.shrink_to_fit();
+    } else {
+      _write(_wsTx.data(), _wsTx.size());
+    }
+
+    wsTxLock();
+    _wsTxBusy = false;
+    wsTxUnlock();
+  }
+}
+
+bool HttpSecure::wsWaitFlushed(uint32_t timeoutMs) {
+  uint32_t timeout = millis() + timeoutMs;
+  while (true) {
+    wsTxLock();
+    bool idle = _wsTxQueue.empty() && !_wsTxBusy;
+    wsTxUnlock();
+    if (idle) return true;
+    if (!_wsTxTask || (int32_t)(timeout - millis()) <= 0) return false;
+    delay(5);
+  }
+}
+
+void HttpSecure::websocketTxTask(void* arg) {
+  HttpSecure* self = static_cast<HttpSecure*>(arg);
+
+  while (true) {
+    // 큐에 프레임이 들어오거나 종료할 때 알림을 받음
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    self->wsFlushQueue();
+
+    // 연결이 끝났으면 남은 프레임을 버리고 종료 (핸들은 잠금 안에서 지워야 재연결 시 중복 생성이 없음)
+    self->wsTxLock();
+    if (!self->_connected) {
+      self->_wsTxQueue.clear();
+      self->_wsTxTask = nullptr;
+      self->wsTxUnlock();
+      break;
+    }
+    self->wsTxUnlock();
+  }
+
+  vTaskDelete(NULL);
+}
+
+void HttpSecure::startTxTask() {
+  wsTxLock();
+  _wsTxQueue.clear();   // 이전 연결에서 남은 프레임
+  if (_wsTxTask == nullptr) {
+    xTaskCreate(
+      websocketTxTask,
+      "ws_tx_task",
+      3072,
+      this,
+      1,
+      &_wsTxTask
+    );
+  }
+  wsTxUnlock();
+}
+
+void HttpSecure::stopTxTask() {
+  // _connected 가 내려간 뒤 호출. 송신 태스크가 쓰는 중인 연결을 정리하지 않도록 끝날 때까지 대기 (최대 1초)
+  wsTxLock();
+  if (_wsTxTask) xTaskNotifyGive(_wsTxTask);
+  wsTxUnlock();
+
+  uint32_t deadline = millis() + 1000;
+  while (_wsTxTask != nullptr && (int32_t)(deadline - millis()) > 0) {
+    delay(10);
+  }
+}
+
+bool HttpSecure::wsFill(size_t need) {
+  // 수신 버퍼에 need 바이트가 모일 때까지 앞으로 당기며 채움 (프레임 헤더용, 최대 14바이트)
+  while (_rxLen - _rxPos < need) {
+    if (_rxPos > 0) {
+      memmove(_rxBuf, _rxBuf + _rxPos, _rxLen - _rxPos);
+      _rxLen -= _rxPos;
+      _rxPos = 0;
+    }
+    int n = _recv(_rxBuf + _rxLen, sizeof(_rxBuf) - _rxLen);
+    if (n <= 0) return false;
+    _rxLen += n;
+  }
+  return true;
+}
+
+bool HttpSecure::wsReadPayload(uint8_t* dst, size_t len) {
+  // 수신 버퍼에 남은 바이트를 먼저 쓰고, 나머지는 목적지로 바로 읽음
+  size_t got = 0;
+  while (got < len) {
+    int n = _read(dst + got, len - got);
+    if (n <= 0) {
+      Serial.printf("[HTTP] payload 수신 중단됨 (%u / %u)\n", (unsigned)got, (unsigned)len);
+      return false;
     }
+    got += n;
   }
+  return true;
+}
 
-  if (payloadLen > 4096) {
-    Serial.printf("[HTTP] payload too large: %llu bytes\n", payloadLen);
+void HttpSecure::readFrame() {
+  if (!_connected) return;
+
+  // 1. 헤더 (2~14바이트)
+  if (!wsFill(2)) {
     _connected = false;
     return;
   }
 
-  uint8_t mask[4] = {0};
-  if (isMasked) {
-    if (_read(mask, 4) != 4) { end(); return; }
+  uint8_t b0 = _rxBuf[_rxPos];
+  uint8_t b1 = _rxBuf[_rxPos + 1];
+  bool fin = b0 & 0x80;
+  bool rsv1 = b0 & 0x40;
+  uint8_t opcode = b0 & 0x0F;
+  bool isMasked = b1 & 0x80;
+  uint8_t lenCode = b1 & 0x7F;
+
+  size_t hdrLen = 2 + (lenCode == 126 ? 2 : (lenCode == 127 ? 8 : 0)) + (isMasked ? 4 : 0);
+  if (!wsFill(hdrLen)) {
+    _connected = false;
+    return;
   }
 
-  std::vector<uint8_t> payload(payloadLen);
-  size_t totalRead = 0;
-  while (totalRead < payloadLen) {
-    int r = _read(payload.data() + totalRead, payloadLen - totalRead);
-    if (r <= 0) {
-      Serial.printf("[HTTP] payload 수신 중단됨 (%zu / %llu)\n", totalRead, payloadLen);
-      break; // 👉 읽은 만큼 처리 후 종료
+  const uint8_t* h = _rxBuf + _rxPos + 2;
+  uint64_t payloadLen = lenCode;
+  if (lenCode == 126) {
+    payloadLen = (h[0] << 8) | h[1];
+    h += 2;
+  } else if (lenCode == 127) {
+    payloadLen = 0;
+    for (int i = 0; i < 8; ++i) {
+      payloadLen = (payloadLen << 8) | h[i];
     }
-    totalRead += r;
+    h += 8;
   }
 
-  // 마스크 해제
-  if (isMasked) {
-    for (size_t i = 0; i < totalRead; ++i) {
-      payload[i] ^= mask[i % 4];
+  uint8_t mask[4] = {0};
+  if (isMasked) memcpy(mask, h, 4);
+  _rxPos += hdrLen;
+
+  // 2. 제어 프레임 (최대 125바이트, 조각나지 않음) 은 데이터 메시지 조각 사이에도 올 수 있다
+  if (opcode & 0x08) {
+    if (payloadLen > 125 || !fin) {
+      Serial.println("[HTTP] 잘못된 웹소켓 제어 프레임");
+      _connected = false;
+      return;
     }
-  }
+    uint8_t payload[125];
+    if (!wsReadPayload(payload, payloadLen)) {
+      _connected = false;
+      return;
+    }
+    if (isMasked) wsMask(payload, payloadLen, mask, 0);
 
-  // 메시지 처리
-  if (totalRead > 0) {
     switch (opcode) {
-      case 0x1: {  // Text
-        payload.push_back(0);  // Null-terminate
-        String msg = String((char*)payload.data());
-        if (_onMessage) _onMessage(msg);
-
-        msg.toLowerCase();
-        if (msg == "ping") {
-          sendMsgString("pong");
-        }
-        break;
-      }
-      case 0x2: {  // Binary
-        if (_onMessageBinary) _onMessageBinary(payload);
-        break;
-      }
-      case 0x8: {
+      case 0x8:
         _connected = false;  // 직접 end() 호출 X. 수신 태스크에서 정리하게 둔다.
         break;
-      }
-      case 0x9: {  // Ping
-        sendPong(payload);
+      case 0x9:  // Ping
+        sendPong(std::vector<uint8_t>(payload, payload + payloadLen));
         break;
-      }
-      case 0xA: {  // Pong
+      case 0xA:  // Pong
         break;
-      }
-      default: {
+      default:
         Serial.printf("[HTTP] 알 수 없는 웹소켓 opcode: 0x%02X\n", opcode);
         break;
+    }
+    return;
+  }
+
+  // 3. 데이터 프레임: 새 메시지의 첫 조각이거나 이어지는 조각(opcode 0)
+  bool skip = false;
+  if (opcode != 0x0) {
+    if (_wsOpcode != 0) {
+      Serial.println("[HTTP] 이전 웹소켓 메시지가 끝나기 전에 새 메시지 시작, 이전 메시지 버림");
+    }
+    if (opcode != 0x1 && opcode != 0x2) {
+      Serial.printf("[HTTP] 알 수 없는 웹소켓 opcode: 0x%02X\n", opcode);
+      skip = true;
+    }
+    if (rsv1 && !_wsDeflateOn) {
+      Serial.println("[HTTP] 협상하지 않은 압축 웹소켓 메시지");
+      _connected = false;
+      return;
+    }
+    _wsOpcode = skip ? 0 : opcode;
+    _wsCompressed = rsv1;
+    _wsMessage.clear();
+    _wsStreaming = false;
+    _wsDiscarding = skip;
+  } else if (_wsOpcode == 0) {
+    Serial.println("[HTTP] 시작 프레임 없는 continuation 프레임 무시");
+    skip = true;
+  }
+
+  bool binary = (_wsOpcode == 0x2);
+
+  // 한도를 넘는 메시지는 스트림 콜백으로 넘기고, 콜백이 없으면 버린다 (연결은 유지)
+  // 압축된 메시지는 압축 상태의 크기로 판단하며, 해제 전에는 넘길 수 없어 버린다
+  if (!skip && !_wsStreaming && !_wsDiscarding && _wsMessage.size() + payloadLen > _wsMaxMessage) {
+    if (_wsCompressed && !_wsInflateReset) {
+      // 이후 메시지가 이 메시지를 역참조할 수 있으므로 버리고 계속할 수 없음
+      Serial.printf("[HTTP] 압축된 웹소켓 메시지가 한도(%u bytes)를 넘어 연결 종료\n", (unsigned)_wsMaxMessage);
+      _connected = false;
+      return;
+    }
+    if (_onMessageStream && !_wsCompressed) {
+      _wsStreaming = true;
+      if (!_wsMessage.empty()) {
+        _onMessageStream(_wsMessage.data(), _wsMessage.size(), binary, false);
       }
+    } else {
+      Serial.printf("[HTTP] 웹소켓 메시지가 한도(%u bytes)를 넘어 버림\n", (unsigned)_wsMaxMessage);
+      _wsDiscarding = true;
     }
+    _wsMessage.clear();
   }
 
-}
+  if (!skip && !_wsStreaming && !_wsDiscarding) {
+    // 재조립 버퍼에 바로 읽음 (용량은 메시지 사이에 재사용)
+    size_t base = _wsMessage.size();
+    _wsMessage.resize(base + payloadLen);
+    if (!wsReadPayload(_wsMessage.data() + base, payloadLen)) {
+      _connected = false;
+      return;
+    }
+    if (isMasked) wsMask(_wsMessage.data() + base, payloadLen, mask, 0);
+  } else {
+    // 스트리밍/버리기: 수신 버퍼 단위로 읽어서 바로 넘김
+    uint64_t remaining = payloadLen;
+    size_t offset = 0;
+    while (remaining > 0) {
+      if (_rxPos == _rxLen) {
+        _rxPos = _rxLen = 0;
+        int n = _recv(_rxBuf, sizeof(_rxBuf));
+        if (n <= 0) {
+          _connected = false;
+          return;
+        }
+        _rxLen = n;
+      }
+      size_t avail = _rxLen - _rxPos;
+      size_t n = (remaining < avail) ? (size_t)remaining : avail;
+      uint8_t* piece = _rxBuf + _rxPos;
+      _rxPos += n;
+      remaining -= n;
+
+      if (_wsStreaming && !skip) {
+        if (isMasked) wsMask(piece, n, mask, offset);
+        _onMessageStream(piece, n, binary, fin && remaining == 0);
+      }
+      offset += n;
+    }
+    if (_wsStreaming && !skip && fin && payloadLen == 0) {
+      _onMessageStream(nullptr, 0, binary, true);
+    }
+  }
 
+  if (skip || !fin) return;
 
-void HttpSecure::sendPong(const std::vector<uint8_t>& payload) {
-  if (!_connected) return;
+  // 4. 마지막 조각: 메시지 전달
+  uint8_t messageOpcode = _wsOpcode;
+  bool delivered = _wsStreaming || _wsDiscarding;
+  bool compressed = _wsCompressed;
+  _wsOpcode = 0;
+  _wsStreaming = false;
+  _wsDiscarding = false;
+  _wsCompressed = false;
+  if (delivered) return;
 
-  uint8_t header[2];
-  size_t len = payload.size();
-  size_t offset = 2;
+  // 압축 해제 결과가 한도를 넘으면 해제하면서 스트림 콜백으로 넘기거나 버림
+  if (compressed && !wsInflateMessage(messageOpcode == 0x2)) return;
+  std::vector<uint8_t>& message = compressed ? _wsPlain : _wsMessage;
 
-  header[0] = 0x8A; // FIN + pong
-  if (len <= 125) {
-    header[1] = len;
-  } else if (len <= 65535) {
-    header[1] = 126;
-    header[2] = (len >> 8) & 0xFF;
-    header[3] = len & 0xFF;
-    offset = 4;
-  } else {
-    header[1] = 127;
-    // 64bit 길이까지 대응하지 않음
-    return;
+  if (messageOpcode == 0x1) {  // Text
+    String msg;
+    msg.concat((const char*)message.data(), message.size());
+    if (_onMessage) _onMessage(msg);
+
+    if (msg.length() == 4 && msg.equalsIgnoreCase("ping")) {
+      sendMsgString("pong");
+    }
+  } else {  // Binary
+    if (_onMessageBinary) _onMessageBinary(message);
+  }
+  message.clear();
+}
+
+bool HttpSecure::wsInflateMessage(bool binary) {
+  // RFC 7692 7.2.2: 프레임 페이로드를 이은 뒤 00 00 ff ff 를 붙여 해제
+  static const uint8_t tail[4] = { 0x00, 0x00, 0xFF, 0xFF };
+  size_t wireBytes = _wsMessage.size();
+  _wsMessage.insert(_wsMessage.end(), tail, tail + 4);
+  if (_wsInflateReset) _inflater.reset();
+
+  _wsPlain.clear();
+  size_t total = 0;
+  bool streaming = false;
+  bool discarding = false;
+
+  uint32_t start = micros();
+  bool ok = _inflater.inflate(_wsMessage.data(), _wsMessage.size(), [&](const uint8_t* data, size_t len) {
+    total += len;
+    if (discarding) return;
+    if (!streaming && _wsPlain.size() + len > _wsMaxMessage) {
+      if (!_onMessageStream) {
+        // 컨텍스트가 이어지므로 해제는 끝까지 하고 결과만 버림
+        Serial.printf("[HTTP] 웹소켓 메시지가 한도(%u bytes)를 넘어 버림\n", (unsigned)_wsMaxMessage);
+        discarding = true;
+        _wsPlain.clear();
+        return;
+      }
+      streaming = true;
+      if (!_wsPlain.empty()) _onMessageStream(_wsPlain.data(), _wsPlain.size(), binary, false);
+      _wsPlain.clear();
+    }
+    if (streaming) _onMessageStream(data, len, binary, false);
+    else _wsPlain.insert(_wsPlain.end(), data, data + len);
+  });
+  _wsDeflateStats.inflateUs += micros() - start;
+  _wsMessage.clear();
+
+  if (!ok) {
+    Serial.println("[HTTP] permessage-deflate 해제 실패");
+    _connected = false;
+    return false;
+  }
+
+  _wsDeflateStats.rxMessages++;
+  _wsDeflateStats.rxWireBytes += wireBytes;
+  _wsDeflateStats.rxRawBytes += total;
+
+  if (streaming) {
+    _onMessageStream(nullptr, 0, binary, true);
+    return false;
   }
+  return !discarding;
+}
 
-  _write(header, offset);
-  if (len > 0) _write(payload.data(), len);
+
+void HttpSecure::sendPong(const std::vector<uint8_t>& payload) {
+  if (!_connected) return;
+  sendWsFrame(0xA, payload.data(), payload.size());  // 수신 태스크는 큐에 넣기만 하고 바로 돌아감
 }
 
 
@@ -543,49 +1077,42 @@ void HttpSecure::onDisconnected(std::function<void()> cb) {
   _onDisconnected = cb;
 }
 
-void HttpSecure::onMsgString(std::function<void(String)> cb) {
+void HttpSecure::onMsgString(std::function<void(const String&)> cb) {
   _onMessage = cb;
 }
-void HttpSecure::onMsgBinary(std::function<void(std::vector<uint8_t>)> cb) {
+void HttpSecure::onMsgBinary(std::function<void(const std::vector<uint8_t>&)> cb) {
   _onMessageBinary = cb;
 }
 
+void HttpSecure::onMsgStream(std::function<void(const uint8_t*, size_t, bool, bool)> cb) {
+  _onMessageStream = cb;
+}
+
+void HttpSecure::setMaxMessageSize(size_t bytes) {
+  _wsMaxMessage = bytes;
+}
+
 
 void HttpSecure::requestHeader(const String& name, const String& value) {
   _headers[name] = value;
 }
 
 String HttpSecure::responseHeader(const String& name) {
-  String lowerName = name;
-  lowerName.toLowerCase();
-
-  for (const auto& header : _responseHeaders) {
-    String key = header.first;
-    key.toLowerCase();
-    if (key == lowerName) {
-      if (!header.second.empty()) {
-        return header.second.back();  // 가장 마지막 값
-      }
-    }
-  }
-  return "";
+  const char* value = _responseHeaders.get(name.c_str());
+  return value ? String(value) : String();
 }
 
 void HttpSecure::printAllResponseHeaders() {
   Serial.println("[HTTP] 서버 응답 헤더 목록 : ");
-  for (const auto& header : _responseHeaders) {
-    const String& key = header.first;
-    for (const String& value : header.second) {
-      Serial.printf("  %s: %s\n", key.c_str(), value.c_str());
-    }
+  for (uint8_t i = 0; i < _responseHeaders.count(); i++) {
+    Serial.printf("  %s: %s\n", _responseHeaders.name(i), _responseHeaders.value(i));
   }
 }
 
 int HttpSecure::get() {
   int redirectLimit = 5;
   for (int i = 0; i < redirectLimit; ++i) {
-    sendRequest("GET");
-    readResponse();
+    request("GET");
 
     if (_statusCode == 301 || _statusCode == 302) {
       String location = responseHeader("location");
@@ -604,75 +1131,157 @@ int HttpSecure::get() {
 }
 
 int HttpSecure::post(const String& body, const String& contentType) {
-  sendRequest("POST", body, contentType);
-  readResponse();
-  return _statusCode;
+  return request("POST", body, contentType);
 }
 
 int HttpSecure::put(const String& body, const String& contentType) {
-  sendRequest("PUT", body, contentType);
-  readResponse();
-  return _statusCode;
+  return request("PUT", body, contentType);
 }
 
 int HttpSecure::patch(const String& body, const String& contentType) {
-  sendRequest("PATCH", body, contentType);
-  readResponse();
-  return _statusCode;
+  return request("PATCH", body, contentType);
 }
 
 int HttpSecure::del() {
-  sendRequest("DELETE");
-  readResponse();
-  return _statusCode;
+  return request("DELETE");
 }
 
 int HttpSecure::head() {
-  sendRequest("HEAD");
+  return request("HEAD");
+}
+
+int HttpSecure::request(const String& method, const String& body, const String& contentType) {
+  bool reused = _reused;
+  sendRequest(method, body, contentType);
   readResponse();
+
+  // 풀에서 꺼낸 연결을 서버가 막 닫은 경우 새 연결로 한 번만 재시도
+  // 요청이 서버에 닿았을 수 있으면(한 바이트라도 보냄) GET/HEAD 만 다시 보냄 (POST 등이 두 번 처리되지 않도록)
+  bool idempotent = (method == "GET" || method == "HEAD");
+  if (_statusCode == -1 && reused && !_isWebSocket && (idempotent || _txSent == 0)) {
+    Serial.println("[HTTP] 재사용 연결 끊김, 새 연결로 재시도");
+    _pool.discard(_conn);
+    _reused = false;
+    _conn = openConnection();
+    if (!_conn) {
+      _connected = false;
+      return _statusCode;
+    }
+    _connected = true;
+    sendRequest(method, body, contentType);
+    readResponse();
+  }
+
   return _statusCode;
 }
 
-String HttpSecure::responseBody() {
+const String& HttpSecure::responseBody() {
   return _response;
 }
 
+void HttpSecure::streamResponse(bool enabled) {
+  _streamResponse = enabled;
+}
+
+Stream& HttpSecure::responseStream() {
+  return _bodyStream;
+}
+
 int HttpSecure::statusCode() {
   return _statusCode;
 }
 
-void HttpSecure::end() {
-  if (!_connected) return;
+void HttpSecure::setPoolIdleTimeout(uint32_t ms) {
+  _pool.setIdleTimeout(ms);
+}
 
-  _connected = false;  // 연결 끊기 플래그만 설정 (실제 정리는 websocketRecvTask에서 처리)
+void HttpSecure::setPoolMaxPerHost(uint8_t n) {
+  _pool.setMaxPerHost(n);
+}
+
+void HttpSecure::clearPool() {
+  _pool.clear();
+}
+
+bool HttpSecure::connectionReused() {
+  return _reused;
+}
+
+void HttpSecure::setTlsConfig(std::shared_ptr<TlsConfig> config) {
+  _tls = config;
+  _pool.clear();  // 이전 설정으로 맺은 유휴 연결은 재사용하지 않음
+}
+
+void HttpSecure::setTlsSessionCache(uint8_t capacity, bool persistent) {
+  _sessions.setCapacity(capacity);
+  _sessions.setPersistent(persistent);
+}
+
+void HttpSecure::clearTlsSessions() {
+  _sessions.clear();
+}
+
+TlsHandshakeStats HttpSecure::tlsHandshakeStats() {
+  return _sessions.stats();
+}
+
+void HttpSecure::printTlsHandshakeStats() {
+  TlsHandshakeStats s = _sessions.stats();
+  uint32_t total = s.full + s.resumed;
+  Serial.println("[HTTP] TLS 핸드셰이크 통계 : ");
+  Serial.printf("  전체: %u회 (평균 %u ms)\n", (unsigned)s.full, (unsigned)(s.full ? s.fullMs / s.full : 0));
+  Serial.printf("  재개: %u회 (평균 %u ms)\n", (unsigned)s.resumed, (unsigned)(s.resumed ? s.resumedMs / s.resumed : 0));
+  Serial.printf("  재개율: %u%%\n", (unsigned)(total ? s.resumed * 100 / total : 0));
+}
+
+void HttpSecure::end() {
+  if (!_connected) {
+    // 요청 도중 끊긴 HTTP 연결은 여기서 정리 (웹소켓은 수신 태스크가 정리)
+    if (_conn && !_isWebSocket) {
+      _pool.discard(_conn);
+      _conn = nullptr;
+    }
+    return;
+  }
 
-  // 기존 연결 및 SSL 상태 정리
+  // WebSocket close 프레임 전송 (대기 중인 프레임 뒤에 넣고, 연결 플래그를 내리기 전에 다 보낼 때까지 기다림)
   if (_isWebSocket) {
-    // WebSocket close 프레임 전송
-    uint8_t closeFrame[2] = { 0x88, 0x00 }; // FIN + opcode=8 (Close)
-    _write(closeFrame, 2);
+    sendWsFrame(0x8, nullptr, 0);
+    wsWaitFlushed(1000);
     delay(20); // 서버에 close 전달 대기
-
   }
 
+  _connected = false;  // 연결 끊기 플래그만 설정 (실제 정리는 websocketRecvTask에서 처리)
+  wakeRecvTask();      // select() 에서 대기 중인 수신 태스크를 깨움
+
   // 태스크가 정리될 때까지 대기 (최대 1초)
-  uint32_t timeout = millis() + 1000;
-  while (_wsRecvTask != nullptr && millis() < timeout) {
+  uint32_t deadline = millis() + 1000;
+  while (_wsRecvTask != nullptr && (int32_t)(deadline - millis()) > 0) {
     delay(10);
   }
 
-  if (_isSecure) {
-    mbedtls_ssl_close_notify(&_ssl);
-    mbedtls_ssl_free(&_ssl);
-    mbedtls_ssl_config_free(&_conf);
-    mbedtls_ctr_drbg_free(&_ctr_drbg);
+  // 스트리밍 중 남은 본문이 작으면 마저 읽어서 연결을 재사용
+  if (!_isWebSocket && !_bodyDone && _decoder.mode() != HttpBodyDecoder::UNTIL_CLOSE) {
+    uint8_t drain[256];
+    size_t drained = 0;
+    int n;
+    while (drained < 2048 && (n = readBodyChunk(drain, sizeof(drain))) > 0) {
+      drained += n;
+    }
   }
 
-  if (_socket != -1) {
-    close(_socket);
-    _socket = -1;
+  // 응답을 끝까지 읽은 연결은 풀에 반납하고, 나머지는 닫는다
+  if (_conn) {
+    if (_reusable && !_isWebSocket) {
+      _conn->requests++;
+      _pool.release(_conn);
+    } else {
+      _pool.discard(_conn);
+    }
+    _conn = nullptr;
   }
-  
+  _reusable = false;
+
   // 상태 변수 초기화
   _isSecure = false;
   _isWebSocket = false; 
@@ -682,7 +1291,7 @@ void HttpSecure::end() {
   if(!_keepAlive){
     _headers.clear();
   }
-  _responseHeaders.clear();
+  _responseHeaders.reset();
   _response = "";
   _statusCode = -1;
 
@@ -696,12 +1305,22 @@ int HttpSecure::_write(const uint8_t* buf, size_t len) {
   if (!_connected) return -1;
 
 
-  int ret;
-  if (_isSecure) {
-    ret = mbedtls_ssl_write(&_ssl, buf, len);
-  } else {
-    ret = send(_socket, buf, len, 0);
+  if (!_conn) return -1;
+
+  // mbedtls_ssl_write / send 는 일부만 보낼 수 있으므로 끝까지 반복
+  size_t sent = 0;
+  int ret = 0;
+  while (sent < len) {
+    if (_isSecure) {
+      ret = mbedtls_ssl_write(&_conn->ssl, buf + sent, len - sent);
+      if (ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) continue;
+    } else {
+      ret = send(_conn->socket, buf + sent, len - sent, 0);
+    }
+    if (ret < 0) break;
+    sent += ret;
   }
+  _txSent += sent;
 
   if (ret < 0) {
     char errBuf[128];
@@ -711,181 +1330,320 @@ int HttpSecure::_write(const uint8_t* buf, size_t len) {
       snprintf(errBuf, sizeof(errBuf), "errno=%d", errno);
     }
     Serial.printf("[HTTP] _write() 전송 오류: %s\n", errBuf);
-    end(); // 오류 발생 시 연결 종료
+    // 여기서 end() 를 부르면 송신 태스크가 자기 자신의 큐 비우기를 기다리게 되므로 플래그만 내림
+    // 웹소켓은 수신 태스크가, HTTP 요청은 request() 재시도나 end() 가 정리
+    _connected = false;
+    if (_isWebSocket) wakeRecvTask();
+    return ret;
   }
   
-  return ret;
+  return sent;
 
 }
 
 int HttpSecure::_read(uint8_t* buf, size_t len) {
+  if (!_conn) return -1;
+
+  // 수신 버퍼에 남은 바이트가 있으면 먼저 반환
+  if (_rxPos < _rxLen) {
+    size_t n = min(len, _rxLen - _rxPos);
+    memcpy(buf, _rxBuf + _rxPos, n);
+    _rxPos += n;
+    if (_rxPos == _rxLen) _rxPos = _rxLen = 0;
+    return n;
+  }
+
+  return _recv(buf, len);
+}
+
+int HttpSecure::_recv(uint8_t* buf, size_t len) {
+  if (!_conn) return -1;
+
   if (_isSecure) {
-    return mbedtls_ssl_read(&_ssl, buf, len);
+    return mbedtls_ssl_read(&_conn->ssl, buf, len);
   } else {
-    return recv(_socket, buf, len, 0);
+    return recv(_conn->socket, buf, len, 0);
   }
 }
 
+bool HttpSecure::txPut(const char* data, size_t len) {
+  // 고정 버퍼가 차면 보내고 이어서 채움
+  while (len > 0) {
+    size_t n = min(len, sizeof(_txBuf) - _txLen);
+    memcpy(_txBuf + _txLen, data, n);
+    _txLen += n;
+    data += n;
+    len -= n;
+    if (_txLen == sizeof(_txBuf) && !txFlush()) return false;
+  }
+  return true;
+}
+
+bool HttpSecure::txPut(const char* str) {
+  return txPut(str, strlen(str));
+}
+
+bool HttpSecure::txHeader(const char* name, const char* value) {
+  return txPut(name) && txPut(": ", 2) && txPut(value) && txPut("\r\n", 2);
+}
+
+bool HttpSecure::txFlush() {
+  if (_txLen == 0) return true;
+  int ret = _write(_txBuf, _txLen);
+  _txLen = 0;
+  return ret >= 0;
+}
+
 void HttpSecure::sendRequest(const String& method, const String& body, const String& contentType) {
+  _txSent = 0;
   if (!_connected) return;
 
-  String req = method + " " + _path + " HTTP/1.1\r\n";
+  _headRequest = (method == "HEAD");
+  _txLen = 0;
+
+  // 시작줄과 헤더는 고정 버퍼에 직접 기록 (String 이어붙이기 없음)
+  txPut(method.c_str(), method.length());
+  txPut(" ", 1);
+  txPut(_path.c_str(), _path.length());
+  txPut(" HTTP/1.1\r\n");
 
   if (_headers.find("Host") == _headers.end() && _headers.find("host") == _headers.end()) {
-    req += "Host: " + _host + "\r\n";
+    txHeader("Host", _host.c_str());
   }
 
-  // 저장된 쿠키 추가
-  String cookies = getValidCookiesFromLittleFS();
+  // 저장된 쿠키 추가 (RAM 의 쿠키 저장소에서, 파일은 읽지 않음)
+  String cookies = CookieJar::instance().header(_host);
   if (cookies.length() > 0) {
-    req += "Cookie: " + cookies + "\r\n";
+    txHeader("Cookie", cookies.c_str());
   }
 
+  bool hasConnection = false;
   for (auto& kv : _headers) {
-    req += kv.first + ": " + kv.second + "\r\n";
+    txHeader(kv.first.c_str(), kv.second.c_str());
+    if (kv.first.equalsIgnoreCase("Connection")) hasConnection = true;
   }
 
-  if (method == "POST" || method == "PUT") {
-    req += "Content-Type: " + contentType + "\r\n";
-    req += "Content-Length: " + String(body.length()) + "\r\n";
+  // 본문이 있으면 (PATCH 포함) 길이를 알려야 keep-alive 연결에서 경계가 맞음
+  if (method == "POST" || method == "PUT" || body.length() > 0) {
+    char len[12];
+    snprintf(len, sizeof(len), "%u", (unsigned)body.length());
+    txHeader("Content-Type", contentType.c_str());
+    txHeader("Content-Length", len);
   }
 
-  req += "Connection: close\r\n\r\n";
+  // 웹소켓 업그레이드가 아니면 연결을 유지해 다음 요청에서 재사용
+  if (!hasConnection) {
+    txHeader("Connection", "keep-alive");
+  }
+  txPut("\r\n", 2);
 
+  // 본문 앞부분으로 헤더 버퍼의 남은 공간을 채워 첫 TLS 레코드에 함께 보내고,
+  // 나머지는 호출자의 버퍼에서 복사 없이 바로 전송 (레코드 분할은 mbedtls 가 처리)
+  const uint8_t* data = (const uint8_t*)body.c_str();
+  size_t remaining = body.length();
+  size_t head = min(remaining, sizeof(_txBuf) - _txLen);
+  txPut((const char*)data, head);
+  if (!txFlush()) return;
 
-  if (body.length()) req += body;
+  if (remaining > head) {
+    _write(data + head, remaining - head);
+  }
+}
 
+void HttpSecure::readResponse() {
+  if (!readResponseHead()) return;
 
-  int ret = _write((const uint8_t*)req.c_str(), req.length());
-  if (ret < 0) {
-    if (_isSecure) {
-      char err[100];
-      mbedtls_strerror(ret, err, sizeof(err));
-    }
+  // 웹소켓 업그레이드나 스트리밍 모드는 본문을 호출자에게 남겨둠
+  if (_isWebSocket || _streamResponse) return;
+
+  uint8_t buf[1024];
+  int len;
+  while ((len = readBodyChunk(buf, sizeof(buf))) > 0) {
+    _response.concat((const char*)buf, len);
   }
 }
 
-void HttpSecure::readResponse() {
+bool HttpSecure::readResponseHead() {
   _response = "";
-  _responseHeaders.clear();
+  _responseHeaders.reset();
   _statusCode = -1;
+  _reusable = false;
+  _keepConnection = false;
+  _bodyDone = true;
+  _decoder.begin(HttpBodyDecoder::IDENTITY, 0);
+  _rxPos = _rxLen = 0;
+  _bodyStream.reset();
+
+  if (!_conn) return false;
+
+  // 소켓 수신 버퍼로 받아 헤더 파서에 넘기고, 헤더 블록 뒤의 바이트(본문 또는 첫 웹소켓 프레임)는 그대로 남긴다
+  while (!_responseHeaders.done()) {
+    int len = _recv(_rxBuf, sizeof(_rxBuf));
+    if (len <= 0) {
+      if (len < 0 && len != MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+        Serial.println("[HTTP] 응답 수신 중 오류 발생");
+      }
+      return false;
+    }
+    _rxPos = _responseHeaders.feed(_rxBuf, len);
+    _rxLen = len;
+    if (_responseHeaders.failed()) return false;
+  }
+  if (_rxPos == _rxLen) _rxPos = _rxLen = 0;
 
-  const size_t bufSize = 1024;
-  char buf[bufSize + 1];
-  int len = 0;
-  bool headerEnded = false;
-  bool statusParsed = false;
-  String headerBuffer = "";  // 🔥 헤더 버퍼 분리
+  _statusCode = _responseHeaders.status();
 
-  std::function<int(uint8_t*, size_t)> readFunc;
-  if (_isSecure) {
-    readFunc = [&](uint8_t* b, size_t l) {
-      return mbedtls_ssl_read(&_ssl, (unsigned char*)b, l);
-    };
-  } else {
-    readFunc = [&](uint8_t* b, size_t l) {
-      return _read(b, l);
-    };
-  }
-
-  while ((len = readFunc((uint8_t*)buf, bufSize)) > 0) {
-    buf[len] = '\0';
-
-    if (!headerEnded) {
-      headerBuffer += buf;
-
-      int headerEnd = headerBuffer.indexOf("\r\n\r\n");
-      if (headerEnd != -1) {
-        String headerPart = headerBuffer.substring(0, headerEnd);
-        _response = headerBuffer.substring(headerEnd + 4);
-        headerEnded = true;
-
-        // 🔍 상태코드 파싱
-        int statusLineEnd = headerPart.indexOf("\r\n");
-        if (statusLineEnd != -1) {
-          String statusLine = headerPart.substring(0, statusLineEnd);
-          int space1 = statusLine.indexOf(' ');
-          int space2 = statusLine.indexOf(' ', space1 + 1);
-          if (space1 != -1 && space2 != -1) {
-            _statusCode = statusLine.substring(space1 + 1, space2).toInt();
-            statusParsed = true;
-          }
-        }
+  for (uint8_t i = 0; i < _responseHeaders.count(); i++) {
+    if (_responseHeaders.is(i, HttpHeaderParser::SET_COOKIE)) {
+      processSetCookieHeader(_responseHeaders.value(i));
+    }
+  }
 
-        // 🔍 헤더 파싱
-        int lineStart = headerPart.indexOf("\r\n") + 2;
-        while (lineStart < headerPart.length()) {
-          int lineEnd = headerPart.indexOf("\r\n", lineStart);
-          if (lineEnd == -1) {
-          
-            String line = headerPart.substring(lineStart); // 남은 전체 줄
-            int colon = line.indexOf(':');
-            if (colon != -1) {
-              String key = line.substring(0, colon);
-              String value = line.substring(colon + 1);
-              key.trim(); value.trim();
-              key.toLowerCase();
-              _responseHeaders[key].push_back(value);
-
-              if (key == "set-cookie") {
-                processSetCookieHeader(value);
-              }
-            }
-            break;
-          }
-          String line = headerPart.substring(lineStart, lineEnd);
-          lineStart = lineEnd + 2;
-
-          int colon = line.indexOf(':');
-          if (colon != -1) {
-            String key = line.substring(0, colon);
-            String value = line.substring(colon + 1);
-            key.trim(); value.trim();
-            key.toLowerCase();
-            _responseHeaders[key].push_back(value);
-
-            if (key == "set-cookie") {
-              processSetCookieHeader(value);
-            }
-          }
-        }
+  // WebSocket이면 여기서 끝냄
+  if (_isWebSocket) return true;
 
-        // WebSocket이면 여기서 끝냄
-        if (_isWebSocket) return;
+  // 📏 본문 프레이밍 결정
+  _keepConnection = _decoder.beginResponse(_responseHeaders, _headRequest);
 
+  _bodyDone = false;
+  if (_decoder.done()) finishBody();
+  return true;
+}
+
+int HttpSecure::readBodyChunk(uint8_t* buf, size_t len) {
+  if (_bodyDone || len == 0) return 0;
+
+  while (!_decoder.done() && !_decoder.failed()) {
+    // 1. 수신 버퍼에 남은 바이트부터 해석 (청크 크기 줄, CRLF, 트레일러 포함)
+    if (_rxPos < _rxLen) {
+      const uint8_t* data = nullptr;
+      size_t dataLen = 0;
+      _rxPos += _decoder.decode(_rxBuf + _rxPos, _rxLen - _rxPos, len, &data, &dataLen);
+      if (_rxPos == _rxLen) _rxPos = _rxLen = 0;
+
+      if (dataLen > 0) {
+        memcpy(buf, data, dataLen);
+        if (_decoder.done()) finishBody();
+        return dataLen;
       }
-    } else {
-      _response += buf;
+      continue;
     }
+
+    // 2. 본문 구간이면 호출자 버퍼로 바로 읽고, 구분자 구간만 수신 버퍼를 거친다
+    size_t direct = _decoder.directBytes();
+    int n = direct > 0 ? _recv(buf, min(len, direct)) : _recv(_rxBuf, sizeof(_rxBuf));
+
+    if (n <= 0) {
+      // 연결 종료로 끝나는 것은 길이 정보가 없는 본문뿐
+      if (n == 0 || n == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) _decoder.finishOnClose();
+      if (!_decoder.done()) {
+        Serial.println("[HTTP] 응답 수신 중 오류 발생");
+        _bodyDone = true;
+        _keepConnection = false;
+        return 0;
+      }
+      break;
+    }
+
+    if (direct > 0) {
+      _decoder.consumeDirect(n);
+      if (_decoder.done()) finishBody();
+      return n;
+    }
+    _rxLen = n;
   }
 
-  if (len < 0 && len != MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
-    Serial.println("[HTTP] 응답 수신 중 오류 발생");
+  if (_decoder.failed()) {
+    Serial.println("[HTTP] 응답 본문 형식 오류");
+    _bodyDone = true;
+    _keepConnection = false;
+    return 0;
   }
+  finishBody();
+  return 0;
 }
 
+void HttpSecure::finishBody() {
+  if (_bodyDone) return;
+  _bodyDone = true;
 
-String HttpSecure::getCookieFilePath() {
+  // chunked 트레일러는 일반 응답 헤더와 같이 조회할 수 있도록 합침
+  const String& trailers = _decoder.trailers();
+  int lineStart = 0;
+  while (lineStart < (int)trailers.length()) {
+    int lineEnd = trailers.indexOf("\r\n", lineStart);
+    if (lineEnd == -1) lineEnd = trailers.length();
+    _responseHeaders.addLine(trailers.c_str() + lineStart, lineEnd - lineStart);
+    lineStart = lineEnd + 2;
+  }
 
-  // 디렉토리 경로 설정 (절대 경로 사용)
-  String dir = "/cookies";
-  
-  // 디렉토리 존재 확인 및 생성
-  if (!LittleFS.open(dir, "r")) {
-    if (!LittleFS.mkdir(dir)) {
-      Serial.println("[HTTP] LittleFS/cookies 디렉토리 생성 실패! 대체 경로 사용");
-      dir = "/"; // 루트 디렉토리로 대체
+  // 본문이 끝났고 뒤따르는 바이트가 없을 때만 다음 요청에 재사용
+  _reusable = _keepConnection && _decoder.done() && _rxPos == _rxLen;
+}
+
+size_t HttpSecure::readResponseBody(std::function<void(const uint8_t*, size_t)> cb) {
+  uint8_t buf[512];
+  size_t total = 0;
+
+  // 스트림 어댑터에 이미 꺼내둔 바이트부터 전달
+  if (_bodyStream.buffered() > 0) {
+    if (cb) cb(_bodyStream.bufferedData(), _bodyStream.buffered());
+    total += _bodyStream.buffered();
+    _bodyStream.reset();
+  }
+
+  int len;
+  while ((len = readBodyChunk(buf, sizeof(buf))) > 0) {
+    if (cb) cb(buf, len);
+    total += len;
+  }
+  return total;
+}
+
+
+bool HttpBodyStream::fill() {
+  if (_pos < _len) return true;
+  int n = _http->readBodyChunk(_buf, sizeof(_buf));
+  _pos = 0;
+  _len = (n > 0) ? n : 0;
+  return _len > 0;
+}
+
+int HttpBodyStream::available() {
+  // 본문이 남아 있으면 다음 조각을 읽어 두고 개수를 돌려준다
+  if (!fill()) return 0;
+  return _len - _pos;
+}
+
+int HttpBodyStream::read() {
+  if (!fill()) return -1;
+  return _buf[_pos++];
+}
+
+int HttpBodyStream::peek() {
+  if (!fill()) return -1;
+  return _buf[_pos];
+}
+
+size_t HttpBodyStream::readBytes(char* buffer, size_t length) {
+  size_t total = 0;
+  while (total < length) {
+    if (_pos < _len) {
+      size_t n = min(length - total, _len - _pos);
+      memcpy(buffer + total, _buf + _pos, n);
+      _pos += n;
+      total += n;
+      continue;
     }
+    // 남은 요청이 크면 내부 버퍼를 거치지 않고 바로 읽음
+    int n = _http->readBodyChunk((uint8_t*)buffer + total, length - total);
+    if (n <= 0) break;
+    total += n;
   }
-  
-  // 파일 경로 생성
-  String filename = _host + ".json";
-  filename.replace(":", "_"); // 포트 번호가 있는 경우 대체
-  
-  String fullPath = dir + "/" + filename;
-  return fullPath;
+  return total;
 }
 
+
 void HttpSecure::processSetCookieHeader(const String& cookieHeader) {
 
   if (time(nullptr) < 24 * 3600) {
@@ -940,378 +1698,73 @@ void HttpSecure::processSetCookieHeader(const String& cookieHeader) {
   }
 
   if (domain.isEmpty()) domain = _host;
-  storeCookieToLittleFS(name, value, expire);
+  storeCookie(name, value, expire);
 }
 
 
-void HttpSecure::storeCookieToLittleFS(const String& name, const String& value, time_t expire) {
+void HttpSecure::storeCookie(const String& name, const String& value, time_t expire) {
   
   if (time(nullptr) < 24 * 3600) {
     Serial.println("[HTTP] ❌ 시스템 시간이 아직 설정되지 않아 쿠키 저장을 건너뜁니다.");
     return;
   }
 
-  if (!_littlefsInitialized) {
-    Serial.println("[HTTP] 오류! begin() 이후 사용이 가능합니다");
-    return;
-  }
-
-  setenv("TZ", "UTC", 1); // 모든 시간을 UTC로 처리
-  tzset();
-
-  String path = getCookieFilePath();
-  if (path.isEmpty()) {
-    Serial.println("[HTTP] 쿠키 경로 없음 - 저장 실패");
-    return;
-  }
-
-  const size_t maxCookies = 20;
-  DynamicJsonDocument doc(4096);
-  JsonArray arr;
-
-  // 1. 기존 쿠키 파일 로드
-  File file = LittleFS.open(path, "r");
-  if (file) {
-    DeserializationError err = deserializeJson(doc, file);
-    file.close();
-    if (err) {
-      Serial.println("[HTTP] 기존 쿠키 파싱 실패, 새 배열 생성");
-      doc.clear();
-    }
-  }
-  
-  if (doc.isNull()) {
-    doc.to<JsonArray>();
-  }
-  arr = doc.as<JsonArray>();
-
-  // 2. 기존 쿠키 정리 (UTC 기준으로 비교)
-  time_t now = time(nullptr);
-  bool updated = false;
-  
-  for (int i = arr.size() - 1; i >= 0; --i) {
-    JsonObject c = arr[i];
-    if (!c.containsKey("name") || !c.containsKey("expire")) {
-      arr.remove(i);
-      continue;
-    }
-
-    time_t cookieExpire = c["expire"].as<time_t>();
-    if (cookieExpire > 0 && cookieExpire < now) { // UTC 비교
-      arr.remove(i);
-      continue;
-    }
-
-    if (c["name"] == name) {
-      c["value"] = value;
-      c["expire"] = expire; // UTC 값 그대로 저장
-      updated = true;
-    }
-  }
-
-
-  // 3. 새 쿠키 추가 (도메인/경로는 선택적)
-  if (!updated && arr.size() < maxCookies) {
-    JsonObject c = arr.createNestedObject();
-    c["name"] = name;
-    c["value"] = value;
-    c["expire"] = expire; // UTC 값 저장
-    if (!_host.isEmpty()) c["domain"] = _host;
-    c["path"] = "/";
-  }
-
-  // 4. 파일 저장
-  File save = LittleFS.open(path, "w");
-  if (!save) {
-    return;
-  }
-
-  if (serializeJson(doc, save) == 0) {
-    Serial.println("[HTTP] 쿠키 직렬화 실패");
-  }
-  save.close();
+  // RAM 에만 반영하고 파일 저장은 CookieJar 가 모아서 처리 (호스트당 최대 20개)
+  CookieJar::instance().set(_host, name, value, expire, true);
 }
 
-String HttpSecure::getValidCookiesFromLittleFS() {
-  String path = getCookieFilePath();
-  String result = "";
-  time_t now = time(nullptr);
-
-  File file = LittleFS.open(path, "r");
-  if (!file) {
-    return "";
-  }
-
-  DynamicJsonDocument doc(2048);
-  DeserializationError err = deserializeJson(doc, file);
-  file.close();
-
-  if (err) {
-    Serial.printf("[HTTP] 쿠키 JSON 파싱 오류: %s\n", path.c_str());
-    return "";
-  }
-
-  JsonArray arr = doc.as<JsonArray>();
-  bool changed = false;
-
-  for (int i = arr.size() - 1; i >= 0; --i) {
-    JsonObject c = arr[i];
-
-    if (!c.containsKey("name") || !c.containsKey("expire")) {
-      arr.remove(i);
-      changed = true;
-      continue;
-    }
 
-    int64_t expireRaw = c["expire"];
-    time_t expire = (time_t)expireRaw;
-
-    if (expire > 0 && expire < now) {
-      Serial.printf("[HTTP] 쿠키 만료됨: %s (만료시간: %lld, 현재: %ld)\n",
-                    c["name"].as<const char*>(), (long long)expire, now);
-      arr.remove(i);
-      changed = true;
-      continue;
-    }
-
-    // 유효 쿠키 추가
-    if (result.length()) result += "; ";
-    result += String(c["name"].as<const char*>()) + "=" + String(c["value"].as<const char*>());
-  }
-
-  if (changed) {
-    File file = LittleFS.open(path, "w");
-    if (file) {
-      serializeJson(doc, file);
-      file.close();
-      Serial.println("[HTTP] 만료된 쿠키 정리 완료");
-    } else {
-      Serial.printf("[HTTP] 쿠키파일 쓰기 실패 (경로: %s)\n", path.c_str());
-    }
-  }
+bool HttpSecure::mountCookieStorage() {
+  // begin() 전에 쿠키를 다룰 때: 포맷은 하지 않고 마운트와 디렉토리 준비만
+  if (_littlefsInitialized) return true;
+  if (!mountLittleFS(false)) return false;
 
-  return result;
+  _littlefsInitialized = true;
+  _littlefsSuccess = true;
+  CookieJar::instance().setStorageReady(true);
+  return true;
 }
 
-
 void HttpSecure::printAllCookies() {
-
-  if (!_littlefsInitialized) {
-    if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
-      Serial.println("[HTTP] clearAllCookies 실패 - LittleFS 마운트되지 않음");
-      return;
-    }
+  if (!mountCookieStorage()) {
+    Serial.println("[HTTP] printAllCookies - LittleFS 마운트되지 않음 (메모리의 쿠키만 표시)");
   }
-
-  String path = getCookieFilePath();
-  time_t now = time(nullptr);
-
-  File file = LittleFS.open(path, "r");
-  if (!file) {
-    return;
-  }
-
-  DynamicJsonDocument doc(4096);
-  DeserializationError err = deserializeJson(doc, file);
-  file.close();
-
-  if (err) {
-    Serial.printf("[HTTP] 쿠키 JSON 파싱 오류: %s\n", path.c_str());
-    return;
-  }
-
-  JsonArray arr = doc.as<JsonArray>();
-  Serial.printf("[HTTP] 저장된 쿠키 목록 (%s):\n", path.c_str());
-
-  for (JsonObject c : arr) {
-    if (!c.containsKey("name") || !c.containsKey("expire")) continue;
-  
-    int64_t expireRaw = c["expire"];
-    time_t expire = (time_t)expireRaw;
-  
-    String status = (expire > 0 && expire < now) ? "  - 만료:" : "  - 유효:";
-  
-    Serial.printf("%s %s=%s\n", status.c_str(),
-          c["name"].as<const char*>(),
-          c["value"].as<const char*>());
-    Serial.printf("    도메인: %s, 만료: %lld\n",  // %lld 사용
-          c.containsKey("domain") ? c["domain"].as<const char*>() : "(없음)",
-          (long long)expire);
-  }
-
+  CookieJar::instance().print(_host);
 }
 
 void HttpSecure::clearAllCookies() {
-
-  if (!_littlefsInitialized) {
-    if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
-      Serial.println("[HTTP] clearAllCookies 실패 - LittleFS 마운트되지 않음");
-      return;
-    }
-  }
-
-  String dirPath = "/cookies";
-
-  File dir = LittleFS.open(dirPath, "w+");
-  if (!dir || !dir.isDirectory()) {
-    Serial.println("[HTTP] 쿠키 디렉토리 열기 실패 또는 디렉토리 아님");
-    return;
-  }
-
-  File file = dir.openNextFile();
-  while (file) {
-    String filename = file.name();
-    file.close();
-
-    if (LittleFS.remove(dirPath + "/" + filename)) {
-      Serial.printf("[HTTP] 쿠키 삭제됨: %s\n", filename.c_str());
-    } else {
-      Serial.printf("[HTTP] 쿠키 삭제 실패: %s\n", filename.c_str());
-    }
-
-    file = dir.openNextFile();
+  if (!mountCookieStorage()) {
+    Serial.println("[HTTP] clearAllCookies - LittleFS 마운트되지 않음 (메모리의 쿠키만 삭제)");
   }
-
-  Serial.println("[HTTP] 모든 쿠키 삭제 완료");
+  CookieJar::instance().clear();
 }
 
 String HttpSecure::getCookie(const String& domain, const String& name) {
-
-  if (!_littlefsInitialized) {
-    if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
-      Serial.println("[HTTP] clearAllCookies 실패 - LittleFS 마운트되지 않음");
-      return "";
-    }
-  }
-
-  String path = "/cookies/" + domain + ".json";
-  path.replace(":", "_");
-
-  File file = LittleFS.open(path, "r");
-  if (!file) return "";
-
-  DynamicJsonDocument doc(2048);
-  DeserializationError err = deserializeJson(doc, file);
-  file.close();
-  if (err) return "";
-
-  JsonArray arr = doc.as<JsonArray>();
-  time_t now = time(nullptr);
-
-  for (JsonObject c : arr) {
-    if (!c.containsKey("name") || !c.containsKey("value") || !c.containsKey("expire")) continue;
-    if (String(c["name"].as<const char*>()) == name) {
-      time_t exp = c["expire"].as<time_t>();
-      if (exp == 0 || exp > now) {
-        return String(c["value"].as<const char*>());
-      }
-    }
-  }
-
-  return "";
+  mountCookieStorage();
+  return CookieJar::instance().get(domain, name);
 }
 
-
-
 void HttpSecure::setCookie(const String& domain, const String& name, const String& value, time_t expire) {
   if (time(nullptr) < 24 * 3600) {
     log_w("시간정보가 잘못되어 쿠키만료일이 맞지 않을 수 있습니다!");
   }
 
-  if (!_littlefsInitialized) {
-    if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
-      Serial.println("[HTTP] clearAllCookies 실패 - LittleFS 마운트되지 않음");
-      return;
-    }
-  }
-
+  mountCookieStorage();
   if (expire == 0) expire = time(nullptr) + 86400 * 30; // 기본 유효기간: 30일
-
-  String path = "/cookies/" + domain + ".json";
-  path.replace(":", "_");
-
-  DynamicJsonDocument doc(4096);
-  JsonArray arr;
-
-  File file = LittleFS.open(path, "r");
-  if (file) {
-    DeserializationError err = deserializeJson(doc, file);
-    file.close();
-    if (err) doc.clear();
-  }
-
-  if (doc.isNull()) doc.to<JsonArray>();
-  arr = doc.as<JsonArray>();
-
-  bool updated = false;
-  for (JsonObject c : arr) {
-    if (String(c["name"].as<const char*>()) == name) {
-      c["value"] = value;
-      c["expire"] = expire;
-      updated = true;
-      break;
-    }
-  }
-
-  if (!updated) {
-    JsonObject c = arr.createNestedObject();
-    c["name"] = name;
-    c["value"] = value;
-    c["expire"] = expire;
-    c["domain"] = domain;
-    c["path"] = "/";
-  }
-
-  File save = LittleFS.open(path, "w");
-  if (save) {
-    serializeJson(doc, save);
-    save.close();
-  }
+  CookieJar::instance().set(domain, name, value, expire);
 }
 
-
 void HttpSecure::removeCookie(const String& domain, const String& name) {
+  mountCookieStorage();
+  CookieJar::instance().remove(domain, name);
+}
 
-  if (!_littlefsInitialized) {
-    if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
-      Serial.println("[HTTP] clearAllCookies 실패 - LittleFS 마운트되지 않음");
-      return;
-    }
-  }
-
-  String path = "/cookies/" + domain + ".json";
-  path.replace(":", "_");
-
-  File file = LittleFS.open(path, "r");
-  if (!file) return;
-
-  DynamicJsonDocument doc(4096);
-  DeserializationError err = deserializeJson(doc, file);
-  file.close();
-  if (err) return;
-
-  JsonArray arr = doc.as<JsonArray>();
-  bool changed = false;
-
-  for (int i = arr.size() - 1; i >= 0; --i) {
-    JsonObject c = arr[i];
-    if (c.containsKey("name") && String(c["name"].as<const char*>()) == name) {
-      arr.remove(i);
-      changed = true;
-      break;
-    }
-  }
+void HttpSecure::flushCookies() {
+  CookieJar::instance().flush();
+}
 
-  if (changed) {
-    File save = LittleFS.open(path, "w");
-    if (save) {
-      serializeJson(doc, save);
-      save.close();
-      Serial.printf("[HTTP] 쿠키 삭제됨: %s (%s)\n", domain.c_str(), name.c_str());
-    } else {
-      Serial.printf("[HTTP] 쿠키파일 쓰기 실패 (경로: %s)\n", path.c_str());
-    }
-  }
+void HttpSecure::setCookieFlushDelay(uint32_t ms) {
+  CookieJar::instance().setFlushDelay(ms);
 }
 
 
@@ -1353,10 +1806,11 @@ time_t HttpSecure::parseGMTToTimeT(const String& gmtStr) {
 void HttpSecure::debugCookiesystem() {
   Serial.println("[HTTP] 쿠키 디버깅 정보 :");
 
-  if (!LittleFS.begin(false, "/spiffs", 10, "spiffs")) {
+  if (!mountCookieStorage()) {
     Serial.println("[HTTP] LittleFS 마운트 실패");
     return;
   }
+  CookieJar::instance().flush();   // 아직 저장 대기 중인 변경도 파일에 반영
 
   File dir = LittleFS.open("/cookies");
   if (dir && dir.isDirectory()) {
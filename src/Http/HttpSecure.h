@@ -2,9 +2,17 @@
 #define HTTP_SECURE_H
 
 #include <Arduino.h>
+#include <deque>
 #include <map>
 #include <vector>
 
+#include "HttpBodyDecoder.h"
+#include "HttpHeaderParser.h"
+#include "HttpConnectionPool.h"
+#include "TlsSessionCache.h"
+#include "TlsConfig.h"
+#include "WsDeflate.h"
+
 
 extern "C" {
   #include <lwip/sockets.h>
@@ -17,20 +25,67 @@ extern "C" {
 }
 
 
+class HttpSecure;
+
+// 응답 본문을 String 에 모으지 않고 소켓에서 바로 읽는 Stream 어댑터
+// 예: deserializeJson(doc, Http.responseStream());
+class HttpBodyStream : public Stream {
+public:
+  explicit HttpBodyStream(HttpSecure* http) : _http(http) {}
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char* buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t) override { return 0; }
+  void reset() { _pos = _len = 0; }
+  size_t buffered() const { return _len - _pos; }
+  const uint8_t* bufferedData() const { return _buf + _pos; }
+
+private:
+  HttpSecure* _http;
+  uint8_t _buf[128];
+  size_t _pos = 0;
+  size_t _len = 0;
+
+  bool fill();
+};
+
+
 class HttpSecure {
+  friend class HttpBodyStream;
+
 public:
+  // 웹소켓 송신 큐가 가득 찼을 때의 동작
+  enum WsTxPolicy {
+    TX_BLOCK,        // 자리가 날 때까지 대기 (타임아웃이면 실패)
+    TX_DROP_OLDEST,  // 가장 오래된 프레임을 버리고 넣음
+    TX_FAIL          // 바로 실패
+  };
+
   HttpSecure();
 
   bool connected();
   void KeepAlive(bool enabled);
   bool handshake();
-  void sendMsgString(const String& message);
-  void sendMsgBinary(const std::vector<uint8_t>& data);
+  bool sendMsgString(const String& message);   // 송신 큐에 넣지 못하면 false
+  bool sendMsgBinary(const std::vector<uint8_t>& data);
+  void setTxQueue(uint8_t maxFrames, WsTxPolicy policy = TX_BLOCK, uint32_t blockTimeoutMs = 1000);
+
+  // permessage-deflate (RFC 7692). 다음 handshake() 부터 제안하며, 서버가 수락해야 적용된다
+  // windowBits 는 양방향 LZ77 윈도우 (2^bits 바이트, 해제 쪽 링 버퍼 크기)
+  void setCompression(bool enabled, uint8_t windowBits = 10, bool serverNoContextTakeover = false);
+  bool compressionActive();
+  WsDeflateStats compressionStats();
+  void printCompressionStats();
   void onConnected(std::function<void()> cb);
   void onHandshake(std::function<void()> cb);
   void onDisconnected(std::function<void()> cb);
-  void onMsgString(std::function<void(String)> cb);
-  void onMsgBinary(std::function<void(std::vector<uint8_t>)> cb); 
+  void onMsgString(std::function<void(const String&)> cb);
+  void onMsgBinary(std::function<void(const std::vector<uint8_t>&)> cb);   // 참조는 콜백 안에서만 유효
+  void onMsgStream(std::function<void(const uint8_t* data, size_t len, bool binary, bool last)> cb);  // 한도를 넘는 메시지를 조각 단위로 전달
+  void setMaxMessageSize(size_t bytes);   // 재조립해서 onMsgString/onMsgBinary 로 넘길 최대 크기
 
   bool begin(const char* url);  // 예: https://host:port/path
   void requestHeader(const String& name, const String& value);
@@ -42,7 +97,10 @@ public:
   int patch(const String& body, const String& contentType);
   int del();
   int head();
-  String responseBody();
+  const String& responseBody();
+  void streamResponse(bool enabled);   // true 이면 get()/post() 등이 헤더까지만 읽고 본문은 남겨둔다
+  Stream& responseStream();
+  size_t readResponseBody(std::function<void(const uint8_t*, size_t)> cb);
   int statusCode();
   void printAllCookies();
   void clearAllCookies();
@@ -50,10 +108,29 @@ public:
   String getCookie(const String& domain, const String& name);
   void setCookie(const String& domain, const String& name, const String& value, time_t expire = 0);
   void removeCookie(const String& domain, const String& name);
+  void flushCookies();                    // 저장 대기 중인 쿠키 변경을 지금 LittleFS 에 씀
+  void setCookieFlushDelay(uint32_t ms);  // 마지막 변경 후 저장까지 기다리는 시간 (기본 3초)
 
   void end();
   void debugCookiesystem();
 
+  // keep-alive 연결 풀 설정
+  void setPoolIdleTimeout(uint32_t ms);
+  void setPoolMaxPerHost(uint8_t n);
+  void clearPool();
+  bool connectionReused();
+
+  // 공유 TLS 설정 (기본값: TlsConfig::shared())
+  void setTlsConfig(std::shared_ptr<TlsConfig> config);
+
+  // TLS 세션 재개 캐시 설정
+  // persistent 이면 재부팅 후에도 재개하도록 세션(마스터 시크릿 포함)을 NVS 에 평문으로 저장한다
+  // 플래시를 읽을 수 있으면 저장된 세션으로 지난 트래픽을 복호화할 수 있으므로 NVS 암호화나 플래시 암호화가 없는 기기에서는 켜지 말 것
+  void setTlsSessionCache(uint8_t capacity, bool persistent = false);
+  void clearTlsSessions();
+  TlsHandshakeStats tlsHandshakeStats();
+  void printTlsHandshakeStats();
+
 private:
 
   volatile bool _keepAlive = false;
@@ -64,12 +141,10 @@ private:
   bool _littlefsSuccess = false;  // 초기화 성공 여부
 
   TaskHandle_t _wsRecvTask = nullptr;
+  int _wakeSock = -1;                 // 수신 태스크를 select() 에서 깨우는 루프백 UDP 소켓
+  struct sockaddr_in _wakeAddr;
   TaskHandle_t _littlefsTask = nullptr;
-
-  struct LittleFSTaskParams {
-    bool* pInitialized;
-    bool* pSuccess;
-  };
+  SemaphoreHandle_t _littlefsReady = nullptr;   // 마운트 태스크가 끝나면(성공/실패) give
 
   bool _isSecure = false;
   String _host;
@@ -77,38 +152,116 @@ private:
   uint16_t _port;
   std::map<String, String> _headers;
 
-  int _socket;
-  mbedtls_ssl_context _ssl;
-  mbedtls_ssl_config _conf;
-  mbedtls_ctr_drbg_context _ctr_drbg;
+  HttpConnection* _conn = nullptr;
+  HttpConnectionPool _pool;
+  TlsSessionCache _sessions;
+  bool _reused = false;     // 풀에서 꺼낸 연결로 begin() 했는지
+  bool _reusable = false;   // 응답을 끝까지 읽어 풀에 반납 가능한지
+  bool _headRequest = false;
+
+  std::shared_ptr<TlsConfig> _tls;
   bool _connected = false;
 
   int _statusCode = -1;
   String _response;
-  std::map<String, std::vector<String>> _responseHeaders;
+
+  // 응답 본문 수신 상태
+  bool _streamResponse = false;
+  bool _bodyDone = true;
+  bool _keepConnection = false;   // 본문을 끝까지 읽으면 풀에 반납 가능한지
+  HttpBodyDecoder _decoder;
+  uint8_t _txBuf[1024];           // 요청 시작줄과 헤더(+본문 앞부분)를 모아 한 번에 전송
+  size_t _txLen = 0;
+  size_t _txSent = 0;             // 이번 요청에서 소켓에 넘어간 바이트 (재시도 가능 여부 판단)
+  uint8_t _rxBuf[1024];           // 소켓 수신 버퍼 (헤더 뒤 잔여 바이트, 청크 구분자)
+  size_t _rxPos = 0;
+  size_t _rxLen = 0;
+  HttpBodyStream _bodyStream;
+  HttpHeaderParser _responseHeaders;
 
   std::function<void()> _onConnected;
   std::function<void()> _onHandshake;
   std::function<void()> _onDisconnected;
-  std::function<void(String)> _onMessage; // 텍스트 메시지
-  std::function<void(std::vector<uint8_t>)> _onMessageBinary;  // 바이너리 메시지
+  std::function<void(const String&)> _onMessage; // 텍스트 메시지
+  std::function<void(const std::vector<uint8_t>&)> _onMessageBinary;  // 바이너리 메시지 (재조립 버퍼를 그대로 넘김)
+  std::function<void(const uint8_t*, size_t, bool, bool)> _onMessageStream;  // 큰 메시지 조각
+
+  // 웹소켓 메시지 재조립 상태
+  std::vector<uint8_t> _wsMessage;  // 조각난 메시지를 모으는 버퍼 (용량 재사용)
+  uint8_t _wsOpcode = 0;            // 진행 중인 메시지의 opcode (0: 없음)
+  bool _wsStreaming = false;        // 한도를 넘어 스트림 콜백으로 넘기는 중
+  bool _wsDiscarding = false;       // 한도를 넘었고 스트림 콜백이 없어 버리는 중
+  size_t _wsMaxMessage = 8192;
 
+  // 웹소켓 송신 큐 (여러 태스크가 보내도 프레임이 섞이지 않도록 쓰기는 ws_tx_task 하나만 한다)
+  std::deque<std::vector<uint8_t>> _wsTxQueue;   // 마스킹까지 끝난 프레임
+  std::vector<uint8_t> _wsTx;       // 작은 프레임을 모아 한 번에 쓰는 버퍼 (용량 재사용)
+  SemaphoreHandle_t _wsTxLock = nullptr;
+  SemaphoreHandle_t _wsTxSpace = nullptr;   // 큐에 자리가 나면 give (TX_BLOCK 대기용)
+  TaskHandle_t _wsTxTask = nullptr;
+  bool _wsTxBusy = false;           // 큐에서 꺼낸 프레임을 쓰는 중
+  uint8_t _wsTxMax = 16;
+  WsTxPolicy _wsTxPolicy = TX_BLOCK;
+  uint32_t _wsTxTimeout = 1000;
+
+  // permessage-deflate 상태
+  bool _wsDeflateWanted = false;    // 핸드셰이크에서 제안할지
+  uint8_t _wsDeflateBits = 10;
+  bool _wsServerNoContext = false;  // server_no_context_takeover 를 요청할지
+  bool _wsDeflateOn = false;        // 서버가 수락함
+  bool _wsInflateReset = false;     // 메시지마다 해제 컨텍스트를 버림 (server_no_context_takeover)
+  bool _wsCompressed = false;       // 진행 중인 메시지가 압축됨 (첫 프레임의 RSV1)
+  WsDeflater _deflater;             // 송신 태스크들이 같이 쓰므로 _wsTxLock 안에서만 사용
+  WsInflater _inflater;             // 수신 태스크 전용
+  std::vector<uint8_t> _wsPlain;    // 압축 해제한 메시지 (용량 재사용)
+  WsDeflateStats _wsDeflateStats;
+
+  static bool mountLittleFS(bool formatOnFail);   // 마운트(실패 시 선택적으로 포맷) + /cookies 디렉토리 생성
   static void littleFSTask(void* params);
   static void websocketRecvTask(void* arg);
+  static void websocketTxTask(void* arg);
+  void startTxTask();
+  void stopTxTask();
+  void wsTxLock();
+  void wsTxUnlock();
+  bool wsEnqueue(std::vector<uint8_t>& frame, WsTxPolicy policy);
+  void wsFlushQueue();
+  bool wsWaitFlushed(uint32_t timeoutMs);
+  bool openWakeSocket();
+  void wakeRecvTask();
+  bool waitReadable();
+  bool rxBuffered();
   void sendPong(const std::vector<uint8_t>& payload);
 
-  void sendFrame(const String& message);
+  bool sendFrame(const String& message);
+  bool sendWsMessage(uint8_t opcode, const uint8_t* data, size_t len);
+  bool sendWsFrame(uint8_t opcode, const uint8_t* data, size_t len, bool compressed = false);
+  bool wsInflateMessage(bool binary);
+  void negotiateCompression();
   void readFrame();
+  bool wsFill(size_t need);
+  bool wsReadPayload(uint8_t* dst, size_t len);
+
+  String poolKey();
+  HttpConnection* openConnection();
+  int request(const String& method, const String& body = "", const String& contentType = "");
 
   int _write(const uint8_t* buf, size_t len);
   int _read(uint8_t* buf, size_t len);
+  int _recv(uint8_t* buf, size_t len);
+  bool txPut(const char* data, size_t len);
+  bool txPut(const char* str);
+  bool txHeader(const char* name, const char* value);
+  bool txFlush();
   void sendRequest(const String& method, const String& body = "", const String& contentType = "");
   void readResponse();
-  String getCookieFilePath();
+  bool readResponseHead();
+  int readBodyChunk(uint8_t* buf, size_t len);
+  void finishBody();
   void processSetCookieHeader(const String& cookieHeader);
-  void storeCookieToLittleFS(const String& name, const String& value, time_t expire);
+  void storeCookie(const String& name, const String& value, time_t expire);
+  bool mountCookieStorage();
   
-  String getValidCookiesFromLittleFS();
   time_t parseGMTToTimeT(const String& gmtStr);
   
 };
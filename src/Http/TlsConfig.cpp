@@ -0,0 +1,114 @@
+#include "TlsConfig.h"
+
+extern "C" {
+  #include <mbedtls/error.h>
+}
+
+
+std::shared_ptr<TlsConfig> TlsConfig::shared() {
+  static std::shared_ptr<TlsConfig> instance;
+  static SemaphoreHandle_t lock = nullptr;
+
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (lock == nullptr) {
+    lock = xSemaphoreCreateMutex();
+  }
+
+  // 생성에 실패했으면(DRBG 시드 실패, 메모리 부족) 다음 호출에서 다시 시도
+  xSemaphoreTake(lock, portMAX_DELAY);
+  if (!instance) instance = create();
+  std::shared_ptr<TlsConfig> cfg = instance;
+  xSemaphoreGive(lock);
+  return cfg;
+}
+
+std::shared_ptr<TlsConfig> TlsConfig::create(const char* caPem, const int* ciphersuites) {
+  std::shared_ptr<TlsConfig> cfg(new TlsConfig());
+  if (!cfg->init(caPem, ciphersuites)) {
+    return nullptr;
+  }
+  return cfg;
+}
+
+TlsConfig::TlsConfig() {
+  mbedtls_ssl_config_init(&_conf);
+  mbedtls_ctr_drbg_init(&_ctr_drbg);
+  mbedtls_x509_crt_init(&_ca);
+}
+
+TlsConfig::~TlsConfig() {
+  mbedtls_ssl_config_free(&_conf);
+  mbedtls_ctr_drbg_free(&_ctr_drbg);
+  mbedtls_x509_crt_free(&_ca);
+  if (_rngLock) vSemaphoreDelete(_rngLock);
+}
+
+bool TlsConfig::init(const char* caPem, const int* ciphersuites) {
+  _rngLock = xSemaphoreCreateMutex();
+
+  // 1. DRBG 시드 (하드웨어 RNG 로 한 번에 채움)
+  const char* pers = "carmeleon_https";
+  int ret = mbedtls_ctr_drbg_seed(&_ctr_drbg,
+                                  [](void*, unsigned char* output, size_t len) {
+                                    esp_fill_random(output, len);
+                                    return 0;
+                                  },
+                                  nullptr,
+                                  (const unsigned char*)pers,
+                                  strlen(pers));
+  if (ret != 0) {
+    Serial.printf("[HTTP] DRBG 초기화 실패: -0x%04X\n", -ret);
+    return false;
+  }
+
+  // 2. 클라이언트 기본 설정
+  ret = mbedtls_ssl_config_defaults(&_conf,
+                                    MBEDTLS_SSL_IS_CLIENT,
+                                    MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT);
+  if (ret != 0) {
+    Serial.printf("[HTTP] TLS 설정 초기화 실패: -0x%04X\n", -ret);
+    return false;
+  }
+  mbedtls_ssl_conf_rng(&_conf, random, this);
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+  // 3. CA 가 주어지면 서버 인증서를 검증하고, 없으면 기존과 같이 검증하지 않음
+  if (caPem) {
+    ret = mbedtls_x509_crt_parse(&_ca, (const unsigned char*)caPem, strlen(caPem) + 1);
+    if (ret != 0) {
+      char errbuf[128];
+      mbedtls_strerror(ret, errbuf, sizeof(errbuf));
+      Serial.printf("[HTTP] CA 인증서 파싱 실패: %s\n", errbuf);
+      return false;
+    }
+    mbedtls_ssl_conf_ca_chain(&_conf, &_ca, nullptr);
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+  } else {
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);  // 인증서 무시
+  }
+
+  // 4. 암호군 제한 (지정하지 않으면 mbedtls 기본 목록)
+  if (ciphersuites) {
+    for (const int* cs = ciphersuites; *cs != 0; ++cs) {
+      _ciphersuites.push_back(*cs);
+    }
+    _ciphersuites.push_back(0);
+    mbedtls_ssl_conf_ciphersuites(&_conf, _ciphersuites.data());
+  }
+
+  _valid = true;
+  return true;
+}
+
+int TlsConfig::random(void* ctx, unsigned char* output, size_t len) {
+  // 여러 연결이 같은 DRBG 를 공유하므로 직렬화
+  TlsConfig* self = static_cast<TlsConfig*>(ctx);
+  xSemaphoreTake(self->_rngLock, portMAX_DELAY);
+  int ret = mbedtls_ctr_drbg_random(&self->_ctr_drbg, output, len);
+  xSemaphoreGive(self->_rngLock);
+  return ret;
+}
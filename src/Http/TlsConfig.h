@@ -0,0 +1,45 @@
+#ifndef TLS_CONFIG_H
+#define TLS_CONFIG_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+extern "C" {
+  #include <mbedtls/ssl.h>
+  #include <mbedtls/ctr_drbg.h>
+  #include <mbedtls/x509_crt.h>
+}
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+
+// 한 번 구성한 뒤에는 변경하지 않는 TLS 클라이언트 설정 (DRBG, 암호군, CA, 인증모드)
+// 여러 HttpSecure 와 풀의 연결들이 shared_ptr 로 공유하며, 마지막 참조가 사라질 때 해제된다
+class TlsConfig {
+public:
+  static std::shared_ptr<TlsConfig> shared();   // 프로세스 전체 기본 설정 (인증서 검증 안 함)
+  static std::shared_ptr<TlsConfig> create(const char* caPem = nullptr, const int* ciphersuites = nullptr);
+
+  ~TlsConfig();
+  TlsConfig(const TlsConfig&) = delete;
+  TlsConfig& operator=(const TlsConfig&) = delete;
+
+  const mbedtls_ssl_config* conf() const { return &_conf; }
+  bool valid() const { return _valid; }
+
+private:
+  TlsConfig();
+  bool init(const char* caPem, const int* ciphersuites);
+  static int random(void* ctx, unsigned char* output, size_t len);
+
+  mbedtls_ssl_config _conf;
+  mbedtls_ctr_drbg_context _ctr_drbg;
+  mbedtls_x509_crt _ca;
+  std::vector<int> _ciphersuites;   // 0으로 끝나는 목록, _conf 가 참조하므로 함께 유지
+  SemaphoreHandle_t _rngLock = nullptr;
+  bool _valid = false;
+};
+
+#endif
@@ -0,0 +1,261 @@
+// 재개 판별에 세션의 마스터 시크릿이 필요하므로 mbedtls 비공개 필드 접근을 허용
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#include "TlsSessionCache.h"
+
+#include <Preferences.h>
+
+static const char* TLS_SESSION_NVS_NAMESPACE = "tls_sess";
+
+
+TlsSessionCache::TlsSessionCache() {
+}
+
+void TlsSessionCache::lock() {
+  if (_lock == nullptr) {
+    _lock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void TlsSessionCache::unlock() {
+  xSemaphoreGive(_lock);
+}
+
+bool TlsSessionCache::offer(const String& key, mbedtls_ssl_context* ssl) {
+  lock();
+  Entry* entry = findLocked(key);
+  if (!entry && _persistent) {
+    entry = loadFromNVSLocked(key);
+  }
+  if (!entry) {
+    unlock();
+    return false;
+  }
+
+  entry->lastUsed = millis();
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  int ret = mbedtls_ssl_session_load(&session, entry->data.data(), entry->data.size());
+  if (ret == 0) {
+    ret = mbedtls_ssl_set_session(ssl, &session);
+  }
+  mbedtls_ssl_session_free(&session);
+  unlock();
+
+  if (ret != 0) {
+    Serial.printf("[HTTP] TLS 세션 복원 실패 (-0x%04X), 전체 핸드셰이크 진행\n", -ret);
+    remove(key);
+    return false;
+  }
+  return true;
+}
+
+bool TlsSessionCache::save(const String& key, const mbedtls_ssl_context* ssl) {
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  if (mbedtls_ssl_get_session(ssl, &session) != 0) {
+    mbedtls_ssl_session_free(&session);
+    return false;
+  }
+
+  // 필요한 크기를 먼저 구한 뒤 직렬화
+  size_t len = 0;
+  mbedtls_ssl_session_save(&session, nullptr, 0, &len);
+  std::vector<uint8_t> data(len);
+  int ret = (len > 0) ? mbedtls_ssl_session_save(&session, data.data(), data.size(), &len) : -1;
+
+  uint8_t master[48] = {0};
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+  memcpy(master, session.MBEDTLS_PRIVATE(master), sizeof(master));
+#endif
+  mbedtls_ssl_session_free(&session);
+
+  if (ret != 0) return false;
+
+  lock();
+  Entry* entry = findLocked(key);
+  // 재개된 핸드셰이크는 이전 세션의 마스터 시크릿을 그대로 사용한다
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+  bool resumed = entry && memcmp(entry->master, master, sizeof(master)) == 0;
+#else
+  bool resumed = false;
+#endif
+  bool changed = !entry || entry->data != data;
+
+  if (!entry) {
+    if (_capacity == 0) {
+      unlock();
+      return resumed;
+    }
+    // 용량 초과 시 가장 오래 사용하지 않은 항목 제거
+    if (_entries.size() >= _capacity) {
+      size_t oldest = 0;
+      for (size_t i = 1; i < _entries.size(); ++i) {
+        if (_entries[i].lastUsed < _entries[oldest].lastUsed) oldest = i;
+      }
+      _entries.erase(_entries.begin() + oldest);
+    }
+    _entries.emplace_back();
+    entry = &_entries.back();
+    entry->key = key;
+  }
+
+  entry->data = std::move(data);
+  memcpy(entry->master, master, sizeof(master));
+  entry->lastUsed = millis();
+
+  // 새 세션이나 갱신된 티켓일 때만 플래시에 기록
+  if (_persistent && changed) {
+    storeToNVS(*entry);
+  }
+  unlock();
+
+  return resumed;
+}
+
+void TlsSessionCache::remove(const String& key) {
+  lock();
+  for (size_t i = 0; i < _entries.size(); ++i) {
+    if (_entries[i].key == key) {
+      _entries.erase(_entries.begin() + i);
+      break;
+    }
+  }
+  if (_persistent) {
+    removeFromNVS(key);
+  }
+  unlock();
+}
+
+void TlsSessionCache::clear() {
+  lock();
+  _entries.clear();
+  if (_persistent) {
+    Preferences prefs;
+    if (prefs.begin(TLS_SESSION_NVS_NAMESPACE, false)) {
+      prefs.clear();
+      prefs.end();
+    }
+  }
+  unlock();
+}
+
+void TlsSessionCache::setCapacity(uint8_t n) {
+  lock();
+  _capacity = n;
+  while (_entries.size() > _capacity) {
+    _entries.erase(_entries.begin());
+  }
+  unlock();
+}
+
+void TlsSessionCache::setPersistent(bool enabled) {
+  lock();
+  if (enabled && !_persistent) {
+    // 첫 부팅에는 네임스페이스가 없어 읽기 전용 열기가 NVS 오류를 남기므로, 여기서 한 번 쓰기 모드로 열어 만들어 둠
+    Preferences prefs;
+    if (prefs.begin(TLS_SESSION_NVS_NAMESPACE, false)) {
+      prefs.end();
+    } else {
+      Serial.println("[HTTP] TLS 세션 NVS 네임스페이스를 열 수 없어 메모리에만 보관");
+      enabled = false;
+    }
+  }
+  _persistent = enabled;
+  unlock();
+}
+
+void TlsSessionCache::record(bool resumed, uint32_t elapsedMs) {
+  lock();
+  if (resumed) {
+    _stats.resumed++;
+    _stats.resumedMs += elapsedMs;
+  } else {
+    _stats.full++;
+    _stats.fullMs += elapsedMs;
+  }
+  unlock();
+}
+
+TlsHandshakeStats TlsSessionCache::stats() {
+  lock();
+  TlsHandshakeStats s = _stats;
+  unlock();
+  return s;
+}
+
+TlsSessionCache::Entry* TlsSessionCache::findLocked(const String& key) {
+  for (Entry& e : _entries) {
+    if (e.key == key) return &e;
+  }
+  return nullptr;
+}
+
+TlsSessionCache::Entry* TlsSessionCache::loadFromNVSLocked(const String& key) {
+  if (_capacity == 0) return nullptr;
+
+  // 네임스페이스는 setPersistent() 에서 만들어 두었으므로 읽기 전용으로 열어도 됨
+  Preferences prefs;
+  if (!prefs.begin(TLS_SESSION_NVS_NAMESPACE, true)) return nullptr;
+
+  String nk = nvsKey(key);
+  size_t len = prefs.getBytesLength(nk.c_str());
+  std::vector<uint8_t> data(len);
+  if (len > 0) {
+    prefs.getBytes(nk.c_str(), data.data(), len);
+  }
+  prefs.end();
+
+  uint8_t master[48];
+  if (len == 0 || !masterOf(data, master)) return nullptr;
+
+  if (_entries.size() >= _capacity) {
+    _entries.erase(_entries.begin());
+  }
+  _entries.emplace_back();
+  Entry* entry = &_entries.back();
+  entry->key = key;
+  entry->data = std::move(data);
+  memcpy(entry->master, master, sizeof(master));
+  entry->lastUsed = millis();
+  return entry;
+}
+
+void TlsSessionCache::storeToNVS(const Entry& entry) {
+  Preferences prefs;
+  if (!prefs.begin(TLS_SESSION_NVS_NAMESPACE, false)) return;
+  prefs.putBytes(nvsKey(entry.key).c_str(), entry.data.data(), entry.data.size());
+  prefs.end();
+}
+
+void TlsSessionCache::removeFromNVS(const String& key) {
+  Preferences prefs;
+  if (!prefs.begin(TLS_SESSION_NVS_NAMESPACE, false)) return;
+  prefs.remove(nvsKey(key).c_str());
+  prefs.end();
+}
+
+String TlsSessionCache::nvsKey(const String& key) {
+  // NVS 키는 최대 15자이므로 host:port 의 FNV-1a 해시를 사용
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < key.length(); ++i) {
+    h ^= (uint8_t)key[i];
+    h *= 16777619u;
+  }
+  char buf[12];
+  snprintf(buf, sizeof(buf), "s%08lx", (unsigned long)h);
+  return String(buf);
+}
+
+bool TlsSessionCache::masterOf(const std::vector<uint8_t>& data, uint8_t master[48]) {
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  bool ok = mbedtls_ssl_session_load(&session, data.data(), data.size()) == 0;
+  memset(master, 0, 48);
+#if defined(MBEDTLS_SSL_PROTO_TLS1_2)
+  if (ok) memcpy(master, session.MBEDTLS_PRIVATE(master), 48);
+#endif
+  mbedtls_ssl_session_free(&session);
+  return ok;
+}
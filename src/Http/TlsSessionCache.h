@@ -0,0 +1,63 @@
+#ifndef TLS_SESSION_CACHE_H
+#define TLS_SESSION_CACHE_H
+
+#include <Arduino.h>
+#include <vector>
+
+extern "C" {
+  #include <mbedtls/ssl.h>
+}
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+
+struct TlsHandshakeStats {
+  uint32_t full = 0;        // 전체 핸드셰이크 횟수
+  uint32_t resumed = 0;     // 세션 재개(세션 ID/티켓) 횟수
+  uint32_t fullMs = 0;      // 전체 핸드셰이크 누적 소요시간
+  uint32_t resumedMs = 0;   // 세션 재개 누적 소요시간
+};
+
+
+// host:port 별로 직렬화된 mbedtls_ssl_session 을 보관하는 LRU 캐시 (선택적으로 NVS에 영구 저장)
+class TlsSessionCache {
+public:
+  TlsSessionCache();
+
+  bool offer(const String& key, mbedtls_ssl_context* ssl);        // 핸드셰이크 전에 캐시된 세션 설정
+  bool save(const String& key, const mbedtls_ssl_context* ssl);   // 핸드셰이크 후 세션 저장, 재개 여부 반환
+  void remove(const String& key);
+  void clear();
+
+  void setCapacity(uint8_t n);
+  void setPersistent(bool enabled);   // 주의: 마스터 시크릿을 포함한 세션이 NVS 에 평문으로 저장됨
+
+  void record(bool resumed, uint32_t elapsedMs);
+  TlsHandshakeStats stats();
+
+private:
+  struct Entry {
+    String key;
+    std::vector<uint8_t> data;   // mbedtls_ssl_session_save 결과
+    uint8_t master[48];          // 재개 판별용 마스터 시크릿
+    uint32_t lastUsed = 0;
+  };
+
+  std::vector<Entry> _entries;
+  SemaphoreHandle_t _lock = nullptr;
+  uint8_t _capacity = 4;
+  bool _persistent = false;
+  TlsHandshakeStats _stats;
+
+  void lock();
+  void unlock();
+  Entry* findLocked(const String& key);
+  Entry* loadFromNVSLocked(const String& key);
+  void storeToNVS(const Entry& entry);
+  void removeFromNVS(const String& key);
+  static String nvsKey(const String& key);
+  static bool masterOf(const std::vector<uint8_t>& data, uint8_t master[48]);
+};
+
+#endif
@@ -0,0 +1,446 @@
+#include "WsDeflate.h"
+
+// RFC 1951 3.2.5 길이/거리 코드 표
+static const uint16_t LEN_BASE[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LEN_EXTRA[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DIST_BASE[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DIST_EXTRA[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const size_t HASH_BITS = 9;
+static const size_t HASH_SIZE = 1 << HASH_BITS;
+static const int MAX_CHAIN = 8;        // 해시 체인을 따라가 볼 후보 수 (속도 ↔ 압축률)
+static const size_t MIN_MATCH = 3;
+static const size_t MAX_MATCH = 258;
+
+
+// ---------------------------------------------------------------------------
+// 압축
+// ---------------------------------------------------------------------------
+
+static inline uint32_t hash3(const uint8_t* p) {
+  return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (HASH_SIZE - 1);
+}
+
+void WsDeflater::setWindowBits(uint8_t bits) {
+  if (bits < 8) bits = 8;
+  if (bits > 15) bits = 15;
+  if (bits != _windowBits) {
+    _windowBits = bits;
+    release();
+  }
+}
+
+void WsDeflater::release() {
+  _head.clear();
+  _head.shrink_to_fit();
+  _prev.clear();
+  _prev.shrink_to_fit();
+}
+
+void WsDeflater::putBits(uint32_t value, uint8_t count) {
+  _bitBuf |= value << _bitCount;
+  _bitCount += count;
+  while (_bitCount >= 8) {
+    _out->push_back(_bitBuf & 0xFF);
+    _bitBuf >>= 8;
+    _bitCount -= 8;
+  }
+}
+
+void WsDeflater::putCode(uint32_t code, uint8_t count) {
+  uint32_t reversed = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    reversed = (reversed << 1) | (code & 1);
+    code >>= 1;
+  }
+  putBits(reversed, count);
+}
+
+void WsDeflater::putLiteral(uint8_t c) {
+  // 고정 허프만: 0~143 은 8비트, 144~255 는 9비트
+  if (c < 144) putCode(0x30 + c, 8);
+  else putCode(0x190 + (c - 144), 9);
+}
+
+void WsDeflater::putMatch(uint32_t length, uint32_t distance) {
+  int li = 28;
+  while (LEN_BASE[li] > length) li--;
+  uint32_t sym = 257 + li;
+  if (sym < 280) putCode(sym - 256, 7);
+  else putCode(0xC0 + (sym - 280), 8);
+  putBits(length - LEN_BASE[li], LEN_EXTRA[li]);
+
+  int di = 29;
+  while (DIST_BASE[di] > distance) di--;
+  putCode(di, 5);
+  putBits(distance - DIST_BASE[di], DIST_EXTRA[di]);
+}
+
+void WsDeflater::alignByte() {
+  if (_bitCount > 0) {
+    _out->push_back(_bitBuf & 0xFF);
+  }
+  _bitBuf = 0;
+  _bitCount = 0;
+}
+
+void WsDeflater::deflate(const uint8_t* in, size_t len, std::vector<uint8_t>& out) {
+  const size_t windowSize = (size_t)1 << _windowBits;
+  if (_head.empty()) {
+    _head.resize(HASH_SIZE);
+    _prev.resize(windowSize);
+  }
+  // 메시지마다 새로 시작 (_prev 는 이번 메시지에서 넣은 위치만 따라가므로 지울 필요 없음)
+  memset(_head.data(), 0, HASH_SIZE * sizeof(uint32_t));
+
+  out.clear();
+  out.reserve(len / 2 + 8);
+  _out = &out;
+  _bitBuf = 0;
+  _bitCount = 0;
+
+  putBits(0, 1);   // BFINAL = 0
+  putBits(1, 2);   // BTYPE = 01 (고정 허프만)
+
+  size_t i = 0;
+  while (i < len) {
+    size_t bestLen = 0;
+    size_t bestDist = 0;
+
+    if (i + MIN_MATCH <= len) {
+      uint32_t h = hash3(in + i);
+      uint32_t cand = _head[h];
+      size_t maxLen = len - i < MAX_MATCH ? len - i : MAX_MATCH;
+
+      for (int chain = MAX_CHAIN; cand && chain > 0; chain--) {
+        size_t c = cand - 1;
+        if (c >= i || i - c > windowSize) break;
+        if (in[c + bestLen] == in[i + bestLen]) {
+          size_t l = 0;
+          while (l < maxLen && in[c + l] == in[i + l]) l++;
+          if (l > bestLen) {
+            bestLen = l;
+            bestDist = i - c;
+            if (l == maxLen) break;
+          }
+        }
+        uint32_t next = _prev[c & (windowSize - 1)];
+        if (next >= cand) break;
+        cand = next;
+      }
+
+      _prev[i & (windowSize - 1)] = _head[h];
+      _head[h] = i + 1;
+    }
+
+    if (bestLen >= MIN_MATCH) {
+      putMatch(bestLen, bestDist);
+      // 일치 구간 안의 위치도 해시에 넣어 다음 검색에 쓰도록 함
+      for (size_t k = 1; k < bestLen; k++) {
+        size_t p = i + k;
+        if (p + MIN_MATCH > len) break;
+        uint32_t h = hash3(in + p);
+        _prev[p & (windowSize - 1)] = _head[h];
+        _head[h] = p + 1;
+      }
+      i += bestLen;
+    } else {
+      putLiteral(in[i]);
+      i++;
+    }
+  }
+
+  putCode(0, 7);   // 블록 끝 (256)
+
+  // 빈 stored 블록으로 바이트 경계를 맞춘다. 뒤따르는 00 00 ff ff 는 보내지 않음
+  putBits(0, 3);
+  alignByte();
+  _out = nullptr;
+}
+
+
+// ---------------------------------------------------------------------------
+// 해제
+// ---------------------------------------------------------------------------
+
+bool WsInflater::begin(uint8_t windowBits) {
+  if (windowBits < 8) windowBits = 8;
+  if (windowBits > 15) windowBits = 15;
+  size_t size = (size_t)1 << windowBits;
+  if (_window.size() != size) {
+    _window.clear();
+    _window.shrink_to_fit();
+    _window.resize(size);
+  }
+  _windowMask = size - 1;
+  reset();
+  return _window.size() == size;
+}
+
+void WsInflater::reset() {
+  _outPos = 0;
+  _flushed = 0;
+  _history = 0;
+}
+
+void WsInflater::release() {
+  _window.clear();
+  _window.shrink_to_fit();
+  _windowMask = 0;
+  reset();
+}
+
+bool WsInflater::bits(uint8_t need, uint32_t& value) {
+  while (_bitCount < need) {
+    if (_inPos >= _inLen) return false;
+    _bitBuf |= (uint32_t)_in[_inPos++] << _bitCount;
+    _bitCount += 8;
+  }
+  value = _bitBuf & ((1u << need) - 1);
+  _bitBuf >>= need;
+  _bitCount -= need;
+  return true;
+}
+
+bool WsInflater::decode(const Huffman& h, int& symbol) {
+  // 정규 허프만 코드를 한 비트씩 따라가며 길이별 첫 코드와 비교 (RFC 1951 3.2.2)
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (int len = 1; len <= 15; len++) {
+    if (_bitCount == 0) {
+      if (_inPos >= _inLen) return false;
+      _bitBuf = _in[_inPos++];
+      _bitCount = 8;
+    }
+    code |= _bitBuf & 1;
+    _bitBuf >>= 1;
+    _bitCount--;
+
+    int count = h.count[len];
+    if (code - count < first) {
+      symbol = h.symbol[index + (code - first)];
+      return true;
+    }
+    index += count;
+    first += count;
+    first <<= 1;
+    code <<= 1;
+  }
+  return false;
+}
+
+bool WsInflater::build(Huffman& h, const uint8_t* lengths, int n) {
+  memset(h.count, 0, sizeof(h.count));
+  for (int i = 0; i < n; i++) {
+    h.count[lengths[i]]++;
+  }
+  if (h.count[0] == n) return true;   // 코드 없음 (거리 코드를 쓰지 않는 블록)
+
+  int left = 1;
+  for (int len = 1; len <= 15; len++) {
+    left <<= 1;
+    left -= h.count[len];
+    if (left < 0) return false;   // 코드 공간 초과
+  }
+
+  uint16_t offs[16];
+  offs[1] = 0;
+  for (int len = 1; len < 15; len++) {
+    offs[len + 1] = offs[len] + h.count[len];
+  }
+  for (int i = 0; i < n; i++) {
+    if (lengths[i]) h.symbol[offs[lengths[i]]++] = i;
+  }
+  return true;
+}
+
+void WsInflater::fixedTables(const Huffman** lencode, const Huffman** distcode) {
+  static Huffman fixedLen;
+  static Huffman fixedDist;
+  static bool built = false;
+
+  if (!built) {
+    uint8_t lengths[288];
+    int i = 0;
+    for (; i < 144; i++) lengths[i] = 8;
+    for (; i < 256; i++) lengths[i] = 9;
+    for (; i < 280; i++) lengths[i] = 7;
+    for (; i < 288; i++) lengths[i] = 8;
+    build(fixedLen, lengths, 288);
+    for (i = 0; i < 30; i++) lengths[i] = 5;
+    build(fixedDist, lengths, 30);
+    built = true;
+  }
+  *lencode = &fixedLen;
+  *distcode = &fixedDist;
+}
+
+void WsInflater::put(uint8_t c) {
+  _window[_outPos & _windowMask] = c;
+  _outPos++;
+  if (_history <= _windowMask) _history++;
+  // 링 끝에 닿으면 연속된 구간을 넘김
+  if ((_outPos & _windowMask) == 0) flush();
+}
+
+void WsInflater::flush() {
+  if (_outPos == _flushed) return;
+  size_t start = _flushed & _windowMask;
+  size_t n = _outPos - _flushed;
+  _flushed = _outPos;
+  if (_sink) _sink(_window.data() + start, n);
+}
+
+bool WsInflater::stored() {
+  // 바이트 경계로 맞춤 (bits() 는 필요한 만큼만 읽으므로 남은 비트는 7개 이하)
+  _bitBuf = 0;
+  _bitCount = 0;
+  if (_inLen - _inPos < 4) return false;
+
+  uint16_t len = _in[_inPos] | (_in[_inPos + 1] << 8);
+  uint16_t nlen = _in[_inPos + 2] | (_in[_inPos + 3] << 8);
+  _inPos += 4;
+  if ((uint16_t)~nlen != len) return false;
+  if (_inLen - _inPos < len) return false;
+
+  for (uint16_t i = 0; i < len; i++) {
+    put(_in[_inPos++]);
+  }
+  return true;
+}
+
+bool WsInflater::codes(const Huffman& lencode, const Huffman& distcode) {
+  int symbol;
+  do {
+    if (!decode(lencode, symbol)) return false;
+
+    if (symbol < 256) {
+      put(symbol);
+    } else if (symbol > 256) {
+      symbol -= 257;
+      if (symbol >= 29) return false;
+      uint32_t extra;
+      if (!bits(LEN_EXTRA[symbol], extra)) return false;
+      uint32_t len = LEN_BASE[symbol] + extra;
+
+      if (!decode(distcode, symbol) || symbol >= 30) return false;
+      if (!bits(DIST_EXTRA[symbol], extra)) return false;
+      uint32_t dist = DIST_BASE[symbol] + extra;
+      if (dist > _history) return false;   // 윈도우 밖 참조
+
+      while (len--) {
+        put(_window[(_outPos - dist) & _windowMask]);
+      }
+    }
+  } while (symbol != 256);
+  return true;
+}
+
+bool WsInflater::dynamic() {
+  static const uint8_t ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+  uint32_t nlen, ndist, ncode;
+  if (!bits(5, nlen) || !bits(5, ndist) || !bits(4, ncode)) return false;
+  nlen += 257;
+  ndist += 1;
+  ncode += 4;
+  if (nlen > 286 || ndist > 30) return false;
+
+  uint8_t lengths[286 + 30];
+  uint32_t v;
+  for (uint32_t i = 0; i < 19; i++) {
+    if (i < ncode) {
+      if (!bits(3, v)) return false;
+      lengths[ORDER[i]] = v;
+    } else {
+      lengths[ORDER[i]] = 0;
+    }
+  }
+  if (!build(_lencode, lengths, 19)) return false;
+
+  // 길이 코드로 리터럴/길이 + 거리 코드 길이를 읽음
+  uint32_t index = 0;
+  while (index < nlen + ndist) {
+    int symbol;
+    if (!decode(_lencode, symbol)) return false;
+    if (symbol < 16) {
+      lengths[index++] = symbol;
+      continue;
+    }
+
+    uint8_t len = 0;
+    if (symbol == 16) {
+      if (index == 0) return false;
+      len = lengths[index - 1];
+      if (!bits(2, v)) return false;
+      v += 3;
+    } else if (symbol == 17) {
+      if (!bits(3, v)) return false;
+      v += 3;
+    } else {
+      if (!bits(7, v)) return false;
+      v += 11;
+    }
+    if (index + v > nlen + ndist) return false;
+    while (v--) lengths[index++] = len;
+  }
+  if (lengths[256] == 0) return false;   // 블록 끝 코드가 없음
+
+  return build(_lencode, lengths, nlen) && build(_distcode, lengths + nlen, ndist);
+}
+
+bool WsInflater::inflate(const uint8_t* in, size_t len, Sink sink) {
+  if (_window.empty()) return false;
+
+  _in = in;
+  _inLen = len;
+  _inPos = 0;
+  _bitBuf = 0;
+  _bitCount = 0;
+  _sink = sink;
+
+  bool ok = true;
+  while (ok) {
+    // 메시지는 빈 stored 블록(00 00 ff ff)으로 끝나 바이트 경계에서 입력이 정확히 끝난다
+    if (_inPos >= _inLen && _bitCount == 0) break;
+
+    uint32_t last, type;
+    if (!bits(1, last) || !bits(2, type)) {
+      ok = false;
+      break;
+    }
+
+    if (type == 0) {
+      ok = stored();
+    } else if (type == 1) {
+      const Huffman* lencode;
+      const Huffman* distcode;
+      fixedTables(&lencode, &distcode);
+      ok = codes(*lencode, *distcode);
+    } else if (type == 2) {
+      ok = dynamic() && codes(_lencode, _distcode);
+    } else {
+      ok = false;
+    }
+
+    if (last) break;
+  }
+
+  flush();
+  _sink = nullptr;
+  _in = nullptr;
+  return ok;
+}
@@ -0,0 +1,97 @@
+#ifndef WS_DEFLATE_H
+#define WS_DEFLATE_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+
+// permessage-deflate (RFC 7692) 통계. 바이트 수는 메시지 페이로드 기준
+struct WsDeflateStats {
+  uint32_t txMessages = 0;     // 압축해서 보낸 메시지
+  uint32_t txRawBytes = 0;     // 압축 전
+  uint32_t txWireBytes = 0;    // 압축 후
+  uint32_t txSkipped = 0;      // 작거나 줄지 않아 압축 없이 보낸 메시지
+  uint32_t rxMessages = 0;     // 압축 해제한 메시지
+  uint32_t rxWireBytes = 0;    // 압축된 상태
+  uint32_t rxRawBytes = 0;     // 해제 후
+  uint32_t deflateUs = 0;      // 압축에 쓴 CPU 시간 (누적)
+  uint32_t inflateUs = 0;      // 해제에 쓴 CPU 시간 (누적)
+};
+
+
+// 고정 허프만 블록만 쓰는 작은 raw DEFLATE 압축기
+// 메시지마다 독립적으로 압축하므로(no_context_takeover) 메시지 사이에 상태를 남기지 않는다
+class WsDeflater {
+public:
+  void setWindowBits(uint8_t bits);   // 역참조 거리 한도 (8~15). 해시 테이블 크기도 여기에 맞춘다
+
+  // out 에 압축 결과를 채운다 (끝의 00 00 ff ff 는 RFC 7692 7.2.1 에 따라 제외)
+  void deflate(const uint8_t* in, size_t len, std::vector<uint8_t>& out);
+  void release();   // 해시 테이블 해제
+
+private:
+  uint8_t _windowBits = 10;
+  std::vector<uint32_t> _head;   // 3바이트 해시 → 마지막 위치 + 1
+  std::vector<uint32_t> _prev;   // 위치(윈도우 크기로 순환) → 같은 해시의 이전 위치 + 1
+
+  std::vector<uint8_t>* _out = nullptr;
+  uint32_t _bitBuf = 0;
+  uint8_t _bitCount = 0;
+
+  void putBits(uint32_t value, uint8_t count);
+  void putCode(uint32_t code, uint8_t count);   // 허프만 코드는 MSB 부터
+  void putLiteral(uint8_t c);
+  void putMatch(uint32_t length, uint32_t distance);
+  void alignByte();
+};
+
+
+// raw DEFLATE 해제기 (stored / 고정 / 동적 허프만 블록)
+// 출력은 2^windowBits 링 버퍼를 거쳐 조각 단위로 sink 에 넘기므로 메시지 전체를 담을 버퍼가 필요 없다
+// 컨텍스트를 유지하면 이전 메시지의 마지막 윈도우를 역참조할 수 있다
+class WsInflater {
+public:
+  using Sink = std::function<void(const uint8_t* data, size_t len)>;
+
+  bool begin(uint8_t windowBits);   // 링 버퍼 할당
+  void reset();                     // 이전 메시지 컨텍스트를 버림 (no_context_takeover)
+  void release();
+
+  // 한 메시지의 압축 데이터 전체 (프레임 페이로드를 잇고 끝에 00 00 ff ff 를 붙인 것)
+  bool inflate(const uint8_t* in, size_t len, Sink sink);
+
+private:
+  struct Huffman {
+    uint16_t count[16];
+    uint16_t symbol[288];
+  };
+
+  std::vector<uint8_t> _window;
+  size_t _windowMask = 0;
+  uint32_t _outPos = 0;      // 지금까지 쓴 총 바이트 (링 위치는 & _windowMask)
+  uint32_t _flushed = 0;     // sink 로 넘긴 위치
+  uint32_t _history = 0;     // 역참조 가능한 바이트 수 (최대 윈도우 크기)
+
+  const uint8_t* _in = nullptr;
+  size_t _inLen = 0;
+  size_t _inPos = 0;
+  uint32_t _bitBuf = 0;
+  uint8_t _bitCount = 0;
+  Sink _sink;
+  Huffman _lencode;           // 동적 블록용 (태스크 스택을 아끼려고 멤버로 둠)
+  Huffman _distcode;
+
+  bool bits(uint8_t need, uint32_t& value);
+  bool decode(const Huffman& h, int& symbol);
+  bool stored();
+  bool codes(const Huffman& lencode, const Huffman& distcode);
+  bool dynamic();
+  void put(uint8_t c);
+  void flush();
+
+  static bool build(Huffman& h, const uint8_t* lengths, int n);
+  static void fixedTables(const Huffman** lencode, const Huffman** distcode);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef WS_MASK_H
+#define WS_MASK_H
+
+#include <Arduino.h>
+
+// 웹소켓 마스킹 (RFC 6455 5.3). offset 은 페이로드 안에서 data 가 시작하는 위치
+// 4바이트 정렬까지는 바이트 단위로, 이후는 위치에 맞게 회전한 마스크 워드로 32비트씩 XOR
+inline void wsMask(uint8_t* data, size_t len, const uint8_t* mask, size_t offset) {
+  size_t i = 0;
+  while (i < len && ((uintptr_t)(data + i) & 3)) {
+    data[i] ^= mask[(offset + i) & 3];
+    i++;
+  }
+
+  if (len - i >= 4) {
+    uint8_t rotated[4];
+    for (size_t k = 0; k < 4; k++) {
+      rotated[k] = mask[(offset + i + k) & 3];
+    }
+    uint32_t m;
+    memcpy(&m, rotated, 4);
+
+    uint8_t* p = data + i;
+    uint8_t* end = p + ((len - i) & ~(size_t)3);
+    for (; p + 16 <= end; p += 16) {
+      uint32_t w[4];
+      memcpy(w, p, 16);
+      w[0] ^= m; w[1] ^= m; w[2] ^= m; w[3] ^= m;
+      memcpy(p, w, 16);
+    }
+    for (; p < end; p += 4) {
+      uint32_t w;
+      memcpy(&w, p, 4);
+      w ^= m;
+      memcpy(p, &w, 4);
+    }
+    i = p - data;
+  }
+
+  while (i < len) {
+    data[i] ^= mask[(offset + i) & 3];
+    i++;
+  }
+}
+
+#endif
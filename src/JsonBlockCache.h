@@ -0,0 +1,148 @@
+#ifndef JSON_BLOCK_CACHE_H
+#define JSON_BLOCK_CACHE_H
+
+#include <Arduino.h>
+#include "ArduinoJson/ArduinoJson.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ArduinoJson 7 은 문서를 비울 때(clear, deserialize) 메모리를 모두 힙에 돌려준다
+// 메시지마다 Response 를 채우고 비우면 같은 크기의 블록을 계속 할당/해제하게 되므로,
+// 해제된 블록을 2의 거듭제곱 크기별로 보관했다가 다음 문서에 다시 쓴다
+class JsonBlockCache : public ArduinoJson::Allocator {
+public:
+  static JsonBlockCache& instance() {
+    static JsonBlockCache cache;
+    return cache;
+  }
+
+  void* allocate(size_t size) override {
+    int cls = classOf(size);
+    if (cls < 0) {
+      // 큰 블록은 보관하지 않음
+      Header* h = (Header*)malloc(sizeof(Header) + size);
+      if (!h) return nullptr;
+      h->capacity = size;
+      return h + 1;
+    }
+
+    lock();
+    Header* h = _free[cls];
+    if (h) {
+      _free[cls] = h->next;
+      _cached -= h->capacity;
+      _hits++;
+    } else {
+      _misses++;
+    }
+    unlock();
+
+    if (!h) {
+      size_t capacity = (size_t)1 << (cls + MIN_SHIFT);
+      h = (Header*)malloc(sizeof(Header) + capacity);
+      if (!h) return nullptr;
+      h->capacity = capacity;
+    }
+    return h + 1;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    Header* h = (Header*)ptr - 1;
+    int cls = classOf(h->capacity);
+
+    lock();
+    bool keep = cls >= 0 && ((size_t)1 << (cls + MIN_SHIFT)) == h->capacity && _cached + h->capacity <= _limit;
+    if (keep) {
+      h->next = _free[cls];
+      _free[cls] = h;
+      _cached += h->capacity;
+    }
+    unlock();
+
+    if (!keep) free(h);
+  }
+
+  void* reallocate(void* ptr, size_t size) override {
+    if (!ptr) return allocate(size);
+    Header* h = (Header*)ptr - 1;
+    // 줄이는 경우(문자열/풀 shrink)는 블록을 그대로 두어 다음에 재사용
+    if (size <= h->capacity) return ptr;
+
+    void* grown = allocate(size);
+    if (!grown) return nullptr;
+    memcpy(grown, ptr, h->capacity);
+    deallocate(ptr);
+    return grown;
+  }
+
+  void setLimit(size_t bytes) {   // 보관할 최대 바이트 (기본 16KB, 0 이면 보관 안 함)
+    lock();
+    _limit = bytes;
+    unlock();
+    if (_cached > bytes) trim();
+  }
+
+  void trim() {   // 보관 중인 블록을 모두 힙에 돌려줌
+    Header* lists[CLASSES];
+    lock();
+    for (int i = 0; i < CLASSES; i++) {
+      lists[i] = _free[i];
+      _free[i] = nullptr;
+    }
+    _cached = 0;
+    unlock();
+
+    for (int i = 0; i < CLASSES; i++) {
+      while (lists[i]) {
+        Header* next = lists[i]->next;
+        free(lists[i]);
+        lists[i] = next;
+      }
+    }
+  }
+
+  size_t cached() { return _cached; }
+  uint32_t hits() { return _hits; }
+  uint32_t misses() { return _misses; }
+
+private:
+  struct Header {
+    Header* next;      // 보관 중일 때만 사용
+    size_t capacity;   // 헤더 뒤 사용 가능한 바이트
+  };
+
+  static const int MIN_SHIFT = 5;    // 32바이트
+  static const int CLASSES = 10;     // 32B ~ 16KB
+
+  Header* _free[CLASSES] = {};
+  size_t _cached = 0;
+  size_t _limit = 16384;
+  uint32_t _hits = 0;
+  uint32_t _misses = 0;
+  SemaphoreHandle_t _lock = nullptr;
+
+  JsonBlockCache() = default;
+
+  static int classOf(size_t size) {
+    for (int i = 0; i < CLASSES; i++) {
+      if (size <= ((size_t)1 << (i + MIN_SHIFT))) return i;
+    }
+    return -1;
+  }
+
+  void lock() {
+    // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+    if (_lock == nullptr) {
+      _lock = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+  }
+
+  void unlock() {
+    xSemaphoreGive(_lock);
+  }
+};
+
+#endif
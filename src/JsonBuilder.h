@@ -1,47 +1,147 @@
 #pragma once
 #include "ArduinoJson/ArduinoJson.h"
+#include "MsgPackWriter.h"
+#include <string>
 #include <vector>
 
+// 키/값 목록의 값 하나 (스칼라 또는 같은 타입 배열)
+// 값을 문서에 담지 않고 타입과 값(문자열/배열은 포인터)만 들고 있다가 출력 시 바로 쓴다
+// 문자열과 배열은 원본을 가리키므로 send()/api() 호출식 안에서만 유효하다
 class JsonVariantWrapper {
+public:
+    JsonVariantWrapper(const char* val) : _type(STRING) { setString(val ? val : "", val ? strlen(val) : 0); }
+    JsonVariantWrapper(const String& val) : _type(STRING) { setString(val.c_str(), val.length()); }
+    JsonVariantWrapper(const std::string& val) : _type(STRING) { setString(val.c_str(), val.size()); }
+    JsonVariantWrapper(float val) : _type(FLOAT) { _f = val; }
+    JsonVariantWrapper(double val) : _type(DOUBLE) { _d = val; }
+    JsonVariantWrapper(int val) : _type(INT) { _i = val; }
+    JsonVariantWrapper(bool val) : _type(BOOL) { _b = val; }
+    JsonVariantWrapper(std::initializer_list<const char*> list) : _type(STRING_ARRAY) { setArray(list.begin(), list.size()); }
+    JsonVariantWrapper(std::initializer_list<float> list) : _type(FLOAT_ARRAY) { setArray(list.begin(), list.size()); }
+    JsonVariantWrapper(std::initializer_list<double> list) : _type(DOUBLE_ARRAY) { setArray(list.begin(), list.size()); }
+    JsonVariantWrapper(std::initializer_list<int> list) : _type(INT_ARRAY) { setArray(list.begin(), list.size()); }
+
+    bool isArray() const { return _type >= STRING_ARRAY; }
+
+    // JSON 텍스트 (ArduinoJson 의 TextFormatter 로 serializeJson 과 같은 형식)
+    template <typename TFormatter>
+    void writeJson(TFormatter& out) const {
+        if (!isArray()) {
+            writeJsonItem(out, _type, 0);
+            return;
+        }
+        out.writeRaw('[');
+        for (size_t i = 0; i < _array.count; i++) {
+            if (i) out.writeRaw(',');
+            writeJsonItem(out, _type, i);
+        }
+        out.writeRaw(']');
+    }
+
+    void writeMsgPack(MsgPackWriter& out) const {
+        if (!isArray()) {
+            writeMsgPackItem(out, _type, 0);
+            return;
+        }
+        out.array(_array.count);
+        for (size_t i = 0; i < _array.count; i++) {
+            writeMsgPackItem(out, _type, i);
+        }
+    }
+
 private:
-    DynamicJsonDocument _doc;
-    JsonVariant _value;
-    std::vector<JsonVariant> _array;
+    enum Type : uint8_t {
+        STRING,
+        FLOAT,
+        DOUBLE,
+        INT,
+        BOOL,
+        STRING_ARRAY,
+        FLOAT_ARRAY,
+        DOUBLE_ARRAY,
+        INT_ARRAY
+    };
 
-public:
-    JsonVariantWrapper(const char* val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(const String& val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(const std::string& val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val.c_str()); }
-    JsonVariantWrapper(float val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(double val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(int val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(bool val) : _doc(64) { _value = _doc.to<JsonVariant>(); _value.set(val); }
-    JsonVariantWrapper(std::initializer_list<const char*> list) : _doc(256) {
-        JsonArray arr = _doc.to<JsonArray>();
-        for (const char* item : list) arr.add(item);
-        for (JsonVariant v : arr) _array.push_back(v);
+    Type _type;
+    union {
+        struct { const char* ptr; size_t len; } _str;
+        struct { const void* items; size_t count; } _array;
+        float _f;
+        double _d;
+        int _i;
+        bool _b;
+    };
+
+    void setString(const char* s, size_t len) { _str.ptr = s; _str.len = len; }
+    void setArray(const void* items, size_t count) { _array.items = items; _array.count = count; }
+
+    template <typename TFormatter>
+    void writeJsonItem(TFormatter& out, Type type, size_t i) const {
+        switch (type) {
+            case STRING:       out.writeString(_str.ptr, _str.len); break;
+            case FLOAT:        out.writeFloat(_f); break;
+            case DOUBLE:       out.writeFloat(_d); break;
+            case INT:          out.writeInteger(_i); break;
+            case BOOL:         out.writeBoolean(_b); break;
+            case STRING_ARRAY: {
+                const char* s = ((const char* const*)_array.items)[i];
+                if (s) out.writeString(s);
+                else out.writeRaw("null");
+                break;
+            }
+            case FLOAT_ARRAY:  out.writeFloat(((const float*)_array.items)[i]); break;
+            case DOUBLE_ARRAY: out.writeFloat(((const double*)_array.items)[i]); break;
+            case INT_ARRAY:    out.writeInteger(((const int*)_array.items)[i]); break;
+        }
+    }
+
+    void writeMsgPackItem(MsgPackWriter& out, Type type, size_t i) const {
+        switch (type) {
+            case STRING:       out.string(_str.ptr, _str.len); break;
+            case FLOAT:        out.number(_f); break;
+            case DOUBLE:       out.number(_d); break;
+            case INT:          out.integer(_i); break;
+            case BOOL:         out.boolean(_b); break;
+            case STRING_ARRAY: {
+                const char* s = ((const char* const*)_array.items)[i];
+                if (s) out.string(s);
+                else out.nil();
+                break;
+            }
+            case FLOAT_ARRAY:  out.number(((const float*)_array.items)[i]); break;
+            case DOUBLE_ARRAY: out.number(((const double*)_array.items)[i]); break;
+            case INT_ARRAY:    out.integer(((const int*)_array.items)[i]); break;
+        }
     }
-    JsonVariantWrapper(std::initializer_list<float> list) : _doc(256) {
-        JsonArray arr = _doc.to<JsonArray>();
-        for (float item : list) arr.add(item);
-        for (JsonVariant v : arr) _array.push_back(v);
+};
+
+
+// String 뒤에 이어 쓰는 출력 (작은 버퍼에 모았다가 concat 해서 재할당 횟수를 줄임)
+class JsonStringAppender {
+public:
+    explicit JsonStringAppender(String& out) : _out(out) {}
+    ~JsonStringAppender() { flush(); }
+
+    size_t write(uint8_t c) {
+        if (_len == sizeof(_buf)) flush();
+        _buf[_len++] = c;
+        return 1;
     }
-    
-    JsonVariantWrapper(std::initializer_list<double> list) : _doc(256) {
-        JsonArray arr = _doc.to<JsonArray>();
-        for (double item : list) arr.add(item);
-        for (JsonVariant v : arr) _array.push_back(v);
+
+    size_t write(const uint8_t* data, size_t n) {
+        for (size_t i = 0; i < n; i++) write(data[i]);
+        return n;
     }
-    
-    JsonVariantWrapper(std::initializer_list<int> list) : _doc(256) {
-        JsonArray arr = _doc.to<JsonArray>();
-        for (int item : list) arr.add(item);
-        for (JsonVariant v : arr) _array.push_back(v);
+
+    void flush() {
+        if (_len) _out.concat(_buf, _len);
+        _len = 0;
     }
 
-    bool isArray() const { return !_array.empty(); }
-    JsonVariant getValue() const { return _value; }
-    const std::vector<JsonVariant>& getArray() const { return _array; }
+private:
+    String& _out;
+    char _buf[64];
+    size_t _len = 0;
 };
 
 
@@ -49,34 +149,33 @@ class JsonBuilder {
     public:
         template <typename K, typename V>
         void _buildJson(String& out, std::initializer_list<std::pair<K, V>> pairs) {
+            JsonStringAppender appender(out);
+            ArduinoJson::detail::TextFormatter<JsonStringAppender&> formatter(appender);
             bool first = true;
 
             for (const auto& pair : pairs) {
-                if (!first) out += ",";
+                if (!first) formatter.writeRaw(',');
                 first = false;
 
-                out += "\"";
-                out += pair.first;
-                out += "\":";
-
-                JsonVariantWrapper wrapped(pair.second);
-                if (wrapped.isArray()) {
-                    out += "[";
-                    bool firstItem = true;
-                    for (const auto& item : wrapped.getArray()) {
-                        if (!firstItem) out += ",";
-                        firstItem = false;
-
-                        String tmp;
-                        serializeJson(item, tmp);
-                        out += tmp;
-                    }
-                    out += "]";
-                } else {
-                    String tmp;
-                    serializeJson(wrapped.getValue(), tmp);
-                    out += tmp;
-                }
+                formatter.writeString(pair.first);
+                formatter.writeRaw(':');
+
+                const JsonVariantWrapper& wrapped = pair.second;
+                wrapped.writeJson(formatter);
+            }
+            appender.flush();
+        }
+
+        // 같은 내용을 JSON 텍스트를 거치지 않고 MsgPack 맵으로 바로 씀
+        template <typename K, typename V>
+        void _buildMsgPack(MsgPackWriter& out, std::initializer_list<std::pair<K, V>> pairs) {
+            out.map(pairs.size());
+
+            for (const auto& pair : pairs) {
+                out.string(pair.first);
+
+                const JsonVariantWrapper& wrapped = pair.second;
+                wrapped.writeMsgPack(out);
             }
         }
 
@@ -0,0 +1,122 @@
+#ifndef MSGPACK_WRITER_H
+#define MSGPACK_WRITER_H
+
+#include <Arduino.h>
+#include <vector>
+#include "ArduinoJson/ArduinoJson.h"
+
+// 중간 JSON 문서 없이 값을 바로 MsgPack 으로 쓰는 인코더
+// 형식 선택은 serializeMsgPack 과 같다 (정수는 가장 짧은 형식, 손실 없으면 float32)
+class MsgPackWriter {
+public:
+  explicit MsgPackWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+  void map(size_t n) {
+    if (n < 16) put(0x80 | n);
+    else if (n <= 0xFFFF) { put(0xDE); put16(n); }
+    else { put(0xDF); put32(n); }
+  }
+
+  void array(size_t n) {
+    if (n < 16) put(0x90 | n);
+    else if (n <= 0xFFFF) { put(0xDC); put16(n); }
+    else { put(0xDD); put32(n); }
+  }
+
+  void nil() { put(0xC0); }
+
+  void boolean(bool b) { put(b ? 0xC3 : 0xC2); }
+
+  void integer(long long v) {
+    if (v >= 0) {
+      uinteger(v);
+    } else if (v >= -32) {
+      put((uint8_t)(int8_t)v);
+    } else if (v >= -128) {
+      put(0xD0); put((uint8_t)(int8_t)v);
+    } else if (v >= -32768) {
+      put(0xD1); put16((uint16_t)(int16_t)v);
+    } else if (v >= -2147483648LL) {
+      put(0xD2); put32((uint32_t)(int32_t)v);
+    } else {
+      put(0xD3); put64((uint64_t)v);
+    }
+  }
+
+  void uinteger(unsigned long long v) {
+    if (v < 128) put(v);
+    else if (v <= 0xFF) { put(0xCC); put(v); }
+    else if (v <= 0xFFFF) { put(0xCD); put16(v); }
+    else if (v <= 0xFFFFFFFFULL) { put(0xCE); put32(v); }
+    else { put(0xCF); put64(v); }
+  }
+
+  void number(double d) {
+    float f = (float)d;
+    if ((double)f == d) {
+      // 소수부가 없으면 정수로 (serializeMsgPack 과 같은 동작)
+      if (f >= -9.2e18f && f <= 9.2e18f && f == (float)(long long)f) {
+        integer((long long)f);
+        return;
+      }
+      uint32_t bits;
+      memcpy(&bits, &f, 4);
+      put(0xCA); put32(bits);
+    } else {
+      uint64_t bits;
+      memcpy(&bits, &d, 8);
+      put(0xCB); put64(bits);
+    }
+  }
+
+  void string(const char* s, size_t len) {
+    if (len < 32) put(0xA0 | len);
+    else if (len <= 0xFF) { put(0xD9); put(len); }
+    else if (len <= 0xFFFF) { put(0xDA); put16(len); }
+    else { put(0xDB); put32(len); }
+    _out.insert(_out.end(), (const uint8_t*)s, (const uint8_t*)s + len);
+  }
+
+  void string(const char* s) { string(s ? s : "", s ? strlen(s) : 0); }
+  void string(const String& s) { string(s.c_str(), s.length()); }
+
+  // ArduinoJson 값 (배열/객체는 재귀)
+  void value(JsonVariantConst v) {
+    if (v.isNull()) {
+      nil();
+    } else if (v.is<bool>()) {
+      boolean(v.as<bool>());
+    } else if (v.is<long long>()) {
+      integer(v.as<long long>());
+    } else if (v.is<unsigned long long>()) {
+      uinteger(v.as<unsigned long long>());
+    } else if (v.is<double>()) {
+      number(v.as<double>());
+    } else if (v.is<const char*>()) {
+      string(v.as<const char*>());
+    } else if (v.is<JsonArrayConst>()) {
+      JsonArrayConst arr = v.as<JsonArrayConst>();
+      array(arr.size());
+      for (JsonVariantConst item : arr) value(item);
+    } else if (v.is<JsonObjectConst>()) {
+      JsonObjectConst obj = v.as<JsonObjectConst>();
+      map(obj.size());
+      for (JsonPairConst kv : obj) {
+        string(kv.key().c_str(), kv.key().size());
+        value(kv.value());
+      }
+    } else {
+      nil();
+    }
+  }
+
+private:
+  std::vector<uint8_t>& _out;
+
+  void put(uint8_t b) { _out.push_back(b); }
+  void put16(uint16_t v) { put(v >> 8); put(v); }
+  void put32(uint32_t v) { put16(v >> 16); put16(v); }
+  void put64(uint64_t v) { put32(v >> 32); put32(v); }
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "Sha256.h"
+#include "Codec.h"
+#include <string.h>
+
+
+#if defined(ESP_PLATFORM)
+
+Sha256::Sha256() {
+  mbedtls_sha256_init(&_ctx);
+  begin();
+}
+
+Sha256::~Sha256() {
+  mbedtls_sha256_free(&_ctx);
+}
+
+void Sha256::begin() {
+  mbedtls_sha256_starts(&_ctx, 0);
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+  mbedtls_sha256_update(&_ctx, data, len);
+}
+
+void Sha256::finish(uint8_t out[HASH_SIZE]) {
+  mbedtls_sha256_finish(&_ctx, out);
+}
+
+void Sha256::hash(const uint8_t* data, size_t len, uint8_t out[HASH_SIZE]) {
+  // 하드웨어 블록이 다른 태스크에서 사용 중이면 mbedTLS 가 소프트웨어로 대신 계산한다
+  mbedtls_sha256(data, len, out, 0);
+}
+
+#else
+
+static const uint32_t K[64] = {
+  0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+  0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+  0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+  0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+  0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+  0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+  0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+  0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+
+static inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static inline uint32_t load32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void store32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+Sha256::Sha256() {
+  begin();
+}
+
+Sha256::~Sha256() {
+  memset(_block, 0, sizeof(_block));
+}
+
+void Sha256::begin() {
+  static const uint32_t init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  memcpy(_state, init, sizeof(_state));
+  _total = 0;
+  _blockLen = 0;
+}
+
+void Sha256::transform(const uint8_t* block) {
+  // 메시지 스케줄은 16워드 링으로 (스택 256 → 64바이트)
+  uint32_t w[16];
+  for (int i = 0; i < 16; i++) w[i] = load32(block + i * 4);
+
+  uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+  uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t wi;
+    if (i < 16) {
+      wi = w[i];
+    } else {
+      uint32_t w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+      uint32_t s0 = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+      uint32_t s1 = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+      wi = w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+    }
+    uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + wi;
+    uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+
+  _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+  _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+  _total += len;
+
+  // 앞 블록의 나머지를 먼저 채움
+  if (_blockLen) {
+    size_t n = 64 - _blockLen;
+    if (n > len) n = len;
+    memcpy(_block + _blockLen, data, n);
+    _blockLen += n;
+    data += n;
+    len -= n;
+    if (_blockLen < 64) return;
+    transform(_block);
+    _blockLen = 0;
+  }
+
+  // 완전한 블록은 입력에서 바로 처리 (복사 없음)
+  while (len >= 64) {
+    transform(data);
+    data += 64;
+    len -= 64;
+  }
+
+  if (len) {
+    memcpy(_block, data, len);
+    _blockLen = len;
+  }
+}
+
+void Sha256::finish(uint8_t out[HASH_SIZE]) {
+  uint64_t bits = _total * 8;
+
+  _block[_blockLen++] = 0x80;
+  if (_blockLen > 56) {
+    memset(_block + _blockLen, 0, 64 - _blockLen);
+    transform(_block);
+    _blockLen = 0;
+  }
+  memset(_block + _blockLen, 0, 56 - _blockLen);
+  store32(_block + 56, bits >> 32);
+  store32(_block + 60, (uint32_t)bits);
+  transform(_block);
+
+  for (int i = 0; i < 8; i++) store32(out + i * 4, _state[i]);
+  begin();
+}
+
+void Sha256::hash(const uint8_t* data, size_t len, uint8_t out[HASH_SIZE]) {
+  Sha256 sha;
+  sha.update(data, len);
+  sha.finish(out);
+}
+
+#endif
+
+
+String Sha256::hexDigest(const uint8_t* data, size_t len) {
+  uint8_t hash[HASH_SIZE];
+  char text[HASH_SIZE * 2 + 1];
+
+  Sha256::hash(data, len, hash);
+  Codec::hexEncode(hash, HASH_SIZE, text);
+  return String(text);
+}
@@ -0,0 +1,41 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <Arduino.h>
+
+#if defined(ESP_PLATFORM)
+#include <mbedtls/sha256.h>
+#endif
+
+// SHA-256 (ESP32 에서는 mbedTLS → SHA 하드웨어 가속, 그 외에는 블록 단위 소프트웨어 구현)
+// 상태를 모두 객체가 들고 있으므로 태스크마다 따로 만들어 쓰면 동시에 호출해도 안전하다
+class Sha256 {
+public:
+  static const size_t HASH_SIZE = 32;
+
+  Sha256();
+  ~Sha256();
+  Sha256(const Sha256&) = delete;
+  Sha256& operator=(const Sha256&) = delete;
+
+  void begin();
+  void update(const uint8_t* data, size_t len);
+  void finish(uint8_t out[HASH_SIZE]);
+
+  static void hash(const uint8_t* data, size_t len, uint8_t out[HASH_SIZE]);
+  static String hexDigest(const uint8_t* data, size_t len);   // 해시를 소문자 16진수 64자로
+
+private:
+#if defined(ESP_PLATFORM)
+  mbedtls_sha256_context _ctx;
+#else
+  uint32_t _state[8];
+  uint64_t _total = 0;     // 지금까지 넣은 바이트 수
+  uint8_t _block[64];      // 64바이트가 안 되는 나머지
+  size_t _blockLen = 0;
+
+  void transform(const uint8_t* block);
+#endif
+};
+
+#endif
@@ -23,6 +23,17 @@ class VecWriter {
     }
 };
 
+// URL 의 호스트를 백그라운드에서 미리 조회 (연결할 때 DNS 질의를 기다리지 않도록)
+static void prefetchUrlHost(EthernetClass& eth, const String& url) {
+  int hostStart = url.indexOf("://");
+  hostStart = (hostStart == -1) ? 0 : hostStart + 3;
+  int hostEnd = hostStart;
+  while (hostEnd < (int)url.length() && url[hostEnd] != '/' && url[hostEnd] != ':') hostEnd++;
+  if (hostEnd > hostStart) {
+    eth.prefetch(url.substring(hostStart, hostEnd).c_str());
+  }
+}
+
 static void ethernetMaintainTask(void* pvParameters) {
   while (true) {
     Ethernet.maintain();
@@ -44,11 +55,9 @@ Response carmeleonClient::api(
   Encryption enc;
   JsonBuilder builder;
 
-  if (!this->Http.begin(url.c_str())) {
-    Serial.println("HTTP 시작 실패");
-    res.statusCode = 0;
-    return res;
-  }
+  // 키 생성과 본문 작성 동안 호스트 조회를 백그라운드에서 진행 (캐시가 유효하거나 만료가 멀면 생략됨)
+  // begin() 의 조회는 진행 중인 질의를 기다렸다가 결과를 그대로 씀
+  prefetchUrlHost(Eth, url);
 
   // NTP 동기화
   if (time(nullptr) < 24 * 3600) {
@@ -93,27 +102,76 @@ Response carmeleonClient::api(
 
   jsonStr += "}";
 
+  if (!this->Http.begin(url.c_str())) {
+    Serial.println("HTTP 시작 실패");
+    res.statusCode = 0;
+    return res;
+  }
+
   this->Http.requestHeader("User-Agent", userAgent);
+  // 파생 키를 캐시하므로 서버가 세션 동안 같은 salt 를 다시 써도 된다고 알림
+  this->Http.requestHeader("X-Salt-Reuse", DerivedKeyCache::instance().enabled() ? "1" : "0");
+  this->Http.requestHeader("X-Carmeleon-Envelope", String(_envelopeVersion));
+  this->Http.streamResponse(true);
   int status = this->Http.post(jsonStr, "application/json");
   res.statusCode = status;
 
-  String responseBody = this->Http.responseBody();
-  this->Http.end();
-
-  // 복호화
-  DynamicJsonDocument respDoc(512);
-  if (!deserializeJson(respDoc, responseBody)) {
-    if (respDoc.is<JsonArray>() && respDoc.size() == 1 && respDoc[0].is<const char*>()) {
-      String decrypted = enc.decrypt(respDoc[0], key);
-      DeserializationError err = deserializeJson(res.json, decrypted);
-      if (err) {
-        Serial.println("복호화 JSON 파싱 실패");
+  // 서버가 v2 봉투로 응답했으면 바이너리 본문을 받아 제자리 복호화 후 파싱
+  if (_envelopeVersion >= Encryption::ENVELOPE_V2 &&
+      this->Http.responseHeader("X-Carmeleon-Envelope").toInt() == Encryption::ENVELOPE_V2) {
+    // 본문 크기는 서버가 알려준 값을 믿지 않고 상한을 넘으면 읽지 않음 (잘못된 응답 하나로 힙이 바닥나지 않도록)
+    std::vector<uint8_t> body;
+    long expected = this->Http.responseHeader("Content-Length").toInt();
+    bool tooLarge = expected < 0 || (size_t)expected > Encryption::V2_MAX_ENVELOPE;
+    if (!tooLarge) {
+      body.reserve(expected ? expected : 512);
+      Stream& stream = this->Http.responseStream();
+      while (true) {
+        size_t used = body.size();
+        if (used >= Encryption::V2_MAX_ENVELOPE) {
+          // 상한에 딱 맞게 끝난 본문인지 한 바이트 더 읽어 확인
+          uint8_t extra;
+          tooLarge = stream.readBytes((char*)&extra, 1) > 0;
+          break;
+        }
+        size_t chunk = min((size_t)512, Encryption::V2_MAX_ENVELOPE - used);
+        body.resize(used + chunk);
+        size_t n = stream.readBytes((char*)body.data() + used, chunk);
+        body.resize(used + n);
+        if (n == 0) break;
       }
-    } else {
-      res.json = respDoc;
     }
-  } else {
-    res.json = respDoc;
+    this->Http.end();
+    this->Http.streamResponse(false);
+
+    if (tooLarge) {
+      Serial.printf("응답 봉투가 너무 큼 (최대 %u 바이트)\n", (unsigned)Encryption::V2_MAX_ENVELOPE);
+      return res;
+    }
+    if (!enc.decryptV2(body, key) ||
+        deserializeJson(res.json, (const char*)body.data(), body.size())) {
+      Serial.println("복호화 JSON 파싱 실패");
+    }
+    return res;
+  }
+
+  // 응답 본문을 String 으로 모으지 않고 소켓에서 바로 결과 문서로 파싱 (중간 문서 복사 없음)
+  DeserializationError respErr = deserializeJson(res.json, this->Http.responseStream());
+  this->Http.end();
+  this->Http.streamResponse(false);
+
+  // 암호화된 응답(["..."])이면 복호화해서 다시 파싱
+  // 복호화는 버퍼 하나 안에서 제자리로 진행하고, 평문은 String 을 거치지 않고 바로 파싱
+  if (!respErr && res.json.is<JsonArray>() && res.json.size() == 1 && res.json[0].is<const char*>()) {
+    JsonString encrypted = res.json[0].as<JsonString>();
+    std::vector<uint8_t> plain;
+    bool ok = enc.decryptTo(encrypted.c_str(), encrypted.size(), key, plain);
+    res.json.clear();
+    DeserializationError err = ok ? deserializeJson(res.json, (const char*)plain.data(), plain.size())
+                                   : DeserializationError(DeserializationError::InvalidInput);
+    if (err) {
+      Serial.println("복호화 JSON 파싱 실패");
+    }
   }
 
   return res;
@@ -156,13 +214,26 @@ void WSEvent::start() {
     if (_onDisconnected) _onDisconnected();
   });
 
-  _http->onMsgString([this](String msg) {
+  _http->onMsgString([this](const String& msg) {
     if (_onReceiveString) _onReceiveString(msg);
   });
 
-  _http->onMsgBinary([this](std::vector<uint8_t> data) {
+  // 한도를 넘는 큰 메시지(설정, 매니페스트 등)는 조각 단위로 전달
+  _http->setMaxMessageSize(_maxMessageSize);
+  _http->setTxQueue(_txQueueSize, _txPolicy);
+  _http->setCompression(_compression, _compressionBits);
+  if (_onReceiveStream) {
+    _http->onMsgStream([this](const uint8_t* data, size_t len, bool binary, bool last) {
+      if (_onReceiveStream) _onReceiveStream(data, len, binary, last);
+    });
+  } else {
+    _http->onMsgStream(nullptr);
+  }
+
+  _http->onMsgBinary([this](const std::vector<uint8_t>& data) {
     
-    Response res;
+    Response& res = _response;
+    res.reset();
     res.fromMsgpack(data);
 
     //redirect 자동처리
@@ -235,6 +306,7 @@ void WSEvent::start() {
     if (_onReceive) {
       _onReceive(res);
     }
+    res.reset();  // 다음 메시지 전까지 블록을 캐시에 돌려둠
   });
 
   if (!_http->handshake()) {
@@ -256,8 +328,13 @@ void WSEvent::close() {
 
 void WSEvent::onConnected(std::function<void()> cb) { _onConnected = cb; }
 void WSEvent::onDisconnected(std::function<void()> cb) { _onDisconnected = cb; }
-void WSEvent::onReceiveString(std::function<void(String)> cb) { _onReceiveString = cb; }
-void WSEvent::onReceive(std::function<void(Response)> cb) { _onReceive = cb; }
+void WSEvent::onReceiveString(std::function<void(const String&)> cb) { _onReceiveString = cb; }
+void WSEvent::onReceiveStream(std::function<void(const uint8_t*, size_t, bool, bool)> cb) { _onReceiveStream = cb; }
+void WSEvent::setMaxMessageSize(size_t bytes) { _maxMessageSize = bytes; }
+void WSEvent::setTxQueue(uint8_t maxFrames, HttpSecure::WsTxPolicy policy) { _txQueueSize = maxFrames; _txPolicy = policy; }
+void WSEvent::setCompression(bool enabled, uint8_t windowBits) { _compression = enabled; _compressionBits = windowBits; }
+WsDeflateStats WSEvent::compressionStats() { return _http->compressionStats(); }
+void WSEvent::onReceive(std::function<void(Response&)> cb) { _onReceive = cb; }
 void WSEvent::onSend(std::function<void(String)> cb) { _onSend = cb; }
 
 void WSEvent::send(const String& msg) {
@@ -298,10 +375,12 @@ void WSEvent::send(JsonDocument& doc) {
   if(!_WSconn){
     return;
   }
-  std::vector<uint8_t> binaryData;
-  VecWriter writer(binaryData);  
-  serializeMsgPack(doc, writer);  
-  _http->sendMsgBinary(binaryData);
+  lockSend();
+  _packBuf.clear();
+  VecWriter writer(_packBuf);
+  serializeMsgPack(doc, writer);
+  _http->sendMsgBinary(_packBuf);
+  unlockSend();
 
   if (_onSend) {
     String jsonStr;
@@ -318,25 +397,35 @@ void WSEvent::send(std::initializer_list<std::pair<const char*, JsonVariantWrapp
     return;
   }
 
-  String jsonStr = "{";
-  _buildJson(jsonStr, kv); 
-  jsonStr += "}";
-
-  DynamicJsonDocument doc(512);
-  deserializeJson(doc, jsonStr);
-
-  std::vector<uint8_t> binaryData;
-  VecWriter writer(binaryData);  
-  serializeMsgPack(doc, writer);
-
-  _http->sendMsgBinary(binaryData);
+  // 값에서 바로 MsgPack 을 만들고, JSON 텍스트는 onSend 훅이 있을 때만 만든다
+  lockSend();
+  _packBuf.clear();
+  MsgPackWriter writer(_packBuf);
+  _buildMsgPack(writer, kv);
+  _http->sendMsgBinary(_packBuf);
+  unlockSend();
 
   if (_onSend) {
+    String jsonStr = "{";
+    _buildJson(jsonStr, kv);
+    jsonStr += "}";
     _onSend(jsonStr);
   }
 
 }
 
+void WSEvent::lockSend() {
+  // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+  if (_sendLock == nullptr) {
+    _sendLock = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_sendLock, portMAX_DELAY);
+}
+
+void WSEvent::unlockSend() {
+  xSemaphoreGive(_sendLock);
+}
+
 WSEvent& carmeleonClient::ws(const String& url, const std::map<String, String>& headers) {
   for (const auto& h : headers) {
     Http.requestHeader(h.first, h.second);
@@ -344,5 +433,12 @@ WSEvent& carmeleonClient::ws(const String& url, const std::map<String, String>&
   }
   evt._url = url;    
   evt._http = &Http; 
+
+  // start() 와 재연결 때 DNS 질의를 기다리지 않도록 미리 조회
+  prefetchUrlHost(Eth, url);
   return evt;
 }
+
+void carmeleonClient::setEnvelopeVersion(uint8_t version) {
+  _envelopeVersion = (version >= Encryption::ENVELOPE_V2) ? Encryption::ENVELOPE_V2 : Encryption::ENVELOPE_V1;
+}
@@ -6,15 +6,28 @@
 #include "ArduinoJson/ArduinoJson.h"
 #include "Ethernet/EthernetESP32.h"
 #include "Http/HttpSecure.h"
+#include "Http/HttpAsync.h"
 #include "HttpsOTAWrapper.h"
 #include "JsonBuilder.h"
+#include "JsonBlockCache.h"
 
+// 이동만 가능 (큰 문서를 실수로 복사하지 않도록). 콜백에는 참조로 전달된다
 class Response {
   public:
-      DynamicJsonDocument json;
+      JsonDocument json;
       int statusCode;
   
-      Response() : json(8192), statusCode(0) {}
+      // 문서 메모리는 블록 캐시에서 받아, 비우고 다시 채워도 힙을 새로 할당하지 않는다
+      Response() : json(&JsonBlockCache::instance()), statusCode(0) {}
+      Response(Response&&) = default;
+      Response& operator=(Response&&) = default;
+      Response(const Response&) = delete;
+      Response& operator=(const Response&) = delete;
+
+      void reset() {   // 재사용 전 비우기 (블록은 캐시로 돌아간다)
+          json.clear();
+          statusCode = 0;
+      }
   
       void prettyPrint() {
           serializeJsonPretty(json, Serial);
@@ -53,15 +66,27 @@ class WSEvent : public JsonBuilder {
     HttpSecure* _http;
     bool _keepAlive = false;
     bool _WSconn = false;
+    size_t _maxMessageSize = 8192;
+    uint8_t _txQueueSize = 16;
+    HttpSecure::WsTxPolicy _txPolicy = HttpSecure::TX_BLOCK;
+    bool _compression = false;
+    uint8_t _compressionBits = 10;
     String _url;
     std::map<String, String> _customHeaders;
+    Response _response;   // 수신 태스크가 메시지마다 재사용
+    std::vector<uint8_t> _packBuf;            // 송신 MsgPack 버퍼 (용량 재사용)
+    SemaphoreHandle_t _sendLock = nullptr;    // 여러 태스크가 send() 해도 _packBuf 를 나눠 쓰지 않도록
+
+    void lockSend();
+    void unlockSend();
 
   public:
     
     std::function<void()> _onConnected;
     std::function<void()> _onDisconnected;
-    std::function<void(String)> _onReceiveString;
-    std::function<void(Response)> _onReceive;
+    std::function<void(const String&)> _onReceiveString;
+    std::function<void(const uint8_t*, size_t, bool, bool)> _onReceiveStream;
+    std::function<void(Response&)> _onReceive;
     std::function<void(String)> _onSend;
 
     WSEvent();
@@ -70,8 +95,13 @@ class WSEvent : public JsonBuilder {
     void KeepAlive(bool enable);
     void onConnected(std::function<void()> cb);
     void onDisconnected(std::function<void()> cb);
-    void onReceiveString(std::function<void(String)> cb);
-    void onReceive(std::function<void(Response)> cb);
+    void onReceiveString(std::function<void(const String&)> cb);
+    void onReceiveStream(std::function<void(const uint8_t* data, size_t len, bool binary, bool last)> cb);
+    void setMaxMessageSize(size_t bytes);
+    void setTxQueue(uint8_t maxFrames, HttpSecure::WsTxPolicy policy = HttpSecure::TX_BLOCK);
+    void setCompression(bool enabled, uint8_t windowBits = 10);   // permessage-deflate 제안
+    WsDeflateStats compressionStats();
+    void onReceive(std::function<void(Response&)> cb);   // 콜백이 끝나면 다음 메시지에 재사용됨 (보관하려면 std::move)
     void onSend(std::function<void(String)> cb);
 
     void send(const String& msg);
@@ -87,6 +117,7 @@ class carmeleonClient {
   public:
     EthernetClass Eth;
     HttpSecure Http;
+    HttpAsync Async;
     HttpsOTAWrapper Ota;
     WSEvent evt; 
     
@@ -102,6 +133,12 @@ class carmeleonClient {
 
     WSEvent& ws(const String& url, const std::map<String,String>& headers = {});
 
+    // 응답 암호화 봉투 버전 (1: 기존 CBC, 2: GCM 바이너리를 지원한다고 서버에 알림)
+    // 서버가 v2 를 모르면 기존 형식으로 응답하므로 그대로 동작한다
+    void setEnvelopeVersion(uint8_t version);
+
+  private:
+    uint8_t _envelopeVersion = 1;
 
 };
   
@@ -1,160 +1,14 @@
 // secret_key.cpp
 #include "secret_key.h"
+#include "Sha256.h"
 #include <string.h>
 
-char hex[256];
-uint8_t hash[32];
-
-#define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
-#define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
-#define CH(x,y,z) (((x) & (y)) ^ (~(x) & (z)))
-#define MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
-#define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
-#define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
-#define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
-#define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
-
-typedef struct {
-  uint8_t data[64];
-  uint32_t datalen;
-  unsigned long long bitlen;
-  uint32_t state[8];
-} SHA256_CTX;
-
-static const uint32_t k[64] = {
-  0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
-  0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
-  0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
-  0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
-  0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
-  0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
-  0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
-  0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
-};
-
-void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]);
-void sha256_init(SHA256_CTX *ctx);
-void sha256_update(SHA256_CTX *ctx, const uint8_t data[], size_t len);
-void sha256_final(SHA256_CTX *ctx, uint8_t hash[]);
-char *btoh(char *dest, uint8_t *src, int len);
-
-void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
-  uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
-  for (i = 0, j = 0; i < 16; ++i, j += 4)
-    m[i] = ((uint32_t)data[j] << 24) | ((uint32_t)data[j + 1] << 16) | ((uint32_t)data[j + 2] << 8) | ((uint32_t)data[j + 3]);
-  for ( ; i < 64; ++i)
-    m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-
-  a = ctx->state[0];
-  b = ctx->state[1];
-  c = ctx->state[2];
-  d = ctx->state[3];
-  e = ctx->state[4];
-  f = ctx->state[5];
-  g = ctx->state[6];
-  h = ctx->state[7];
-
-  for (i = 0; i < 64; ++i) {
-    t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-    t2 = EP0(a) + MAJ(a,b,c);
-    h = g;
-    g = f;
-    f = e;
-    e = d + t1;
-    d = c;
-    c = b;
-    b = a;
-    a = t1 + t2;
-  }
-
-  ctx->state[0] += a;
-  ctx->state[1] += b;
-  ctx->state[2] += c;
-  ctx->state[3] += d;
-  ctx->state[4] += e;
-  ctx->state[5] += f;
-  ctx->state[6] += g;
-  ctx->state[7] += h;
-}
-
-void sha256_init(SHA256_CTX *ctx) {
-  ctx->datalen = 0;
-  ctx->bitlen = 0;
-  ctx->state[0] = 0x6a09e667;
-  ctx->state[1] = 0xbb67ae85;
-  ctx->state[2] = 0x3c6ef372;
-  ctx->state[3] = 0xa54ff53a;
-  ctx->state[4] = 0x510e527f;
-  ctx->state[5] = 0x9b05688c;
-  ctx->state[6] = 0x1f83d9ab;
-  ctx->state[7] = 0x5be0cd19;
-}
-
-void sha256_update(SHA256_CTX *ctx, const uint8_t data[], size_t len) {
-  for (uint32_t i = 0; i < len; ++i) {
-    ctx->data[ctx->datalen] = data[i];
-    ctx->datalen++;
-    if (ctx->datalen == 64) {
-      sha256_transform(ctx, ctx->data);
-      ctx->bitlen += 512;
-      ctx->datalen = 0;
-    }
-  }
-}
-
-void sha256_final(SHA256_CTX *ctx, uint8_t hash[]) {
-  uint32_t i = ctx->datalen;
-  if (i < 56) {
-    ctx->data[i++] = 0x80;
-    while (i < 56) ctx->data[i++] = 0x00;
-  } else {
-    ctx->data[i++] = 0x80;
-    while (i < 64) ctx->data[i++] = 0x00;
-    sha256_transform(ctx, ctx->data);
-    memset(ctx->data, 0, 56);
-  }
-  ctx->bitlen += ctx->datalen * 8;
-  ctx->data[63] = ctx->bitlen;
-  ctx->data[62] = ctx->bitlen >> 8;
-  ctx->data[61] = ctx->bitlen >> 16;
-  ctx->data[60] = ctx->bitlen >> 24;
-  ctx->data[59] = ctx->bitlen >> 32;
-  ctx->data[58] = ctx->bitlen >> 40;
-  ctx->data[57] = ctx->bitlen >> 48;
-  ctx->data[56] = ctx->bitlen >> 56;
-  sha256_transform(ctx, ctx->data);
-  for (i = 0; i < 4; ++i) {
-    hash[i]      = (ctx->state[0] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 4]  = (ctx->state[1] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 8]  = (ctx->state[2] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 12] = (ctx->state[3] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 16] = (ctx->state[4] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 20] = (ctx->state[5] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 24] = (ctx->state[6] >> (24 - i * 8)) & 0x000000ff;
-    hash[i + 28] = (ctx->state[7] >> (24 - i * 8)) & 0x000000ff;
-  }
-}
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
-char *btoh(char *dest, uint8_t *src, int len) {
-  char *d = dest;
-  while (len--) sprintf(d, "%02x", *src++), d += 2;
-  return dest;
-}
-
-String SHA256(const String& data) {
-  uint8_t data_buffer[data.length()];
-  for (int i = 0; i < data.length(); i++) {
-    data_buffer[i] = (uint8_t)data.charAt(i);
-  }
-  SHA256_CTX ctx;
-  sha256_init(&ctx);
-  sha256_update(&ctx, data_buffer, data.length());
-  sha256_final(&ctx, hash);
-  return String(btoh(hex, hash, 32));
-}
-
-String secret_key(uint64_t millis) {
-    uint64_t tmp = millis / 10000000;
+static String deriveSecretKey(uint64_t bucket) {
+    uint64_t tmp = bucket;
 
     tmp = (tmp + 15445969) * 154405969ULL;
 
@@ -182,10 +36,104 @@ String secret_key(uint64_t millis) {
             digit += c;
         }
     }
-    String fullHash = SHA256(digit);
+    String fullHash = Sha256::hexDigest((const uint8_t*)digit.c_str(), digit.length());
     int pos = fullHash.indexOf('9');
     if (pos != -1) {
         return fullHash.substring(0, pos);
     }
     return fullHash;
-}
\ No newline at end of file
+}
+
+// 키는 10000000ms(약 2.8시간) 구간마다 바뀌므로 현재/다음 구간 키를 보관해 둔다
+static const uint64_t KEY_BUCKET_MS = 10000000;
+static const uint64_t KEY_PRECOMPUTE_MS = 600000;   // 구간이 끝나기 10분 전부터 다음 키를 미리 계산
+static const uint64_t NO_BUCKET = UINT64_MAX;
+
+struct SecretKeySlot {
+    uint64_t bucket = NO_BUCKET;
+    String key;
+};
+
+static SecretKeySlot keySlots[2];
+static SemaphoreHandle_t keyLock = nullptr;
+
+static void lockKeys() {
+    // 전역 생성자 시점에는 만들지 않고 처음 사용할 때 생성
+    if (keyLock == nullptr) {
+        keyLock = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(keyLock, portMAX_DELAY);
+}
+
+static void unlockKeys() {
+    xSemaphoreGive(keyLock);
+}
+
+static SecretKeySlot* findKeyLocked(uint64_t bucket) {
+    for (SecretKeySlot& slot : keySlots) {
+        if (slot.bucket == bucket) return &slot;
+    }
+    return nullptr;
+}
+
+static SecretKeySlot* slotForLocked(uint64_t bucket) {
+    // 빈 슬롯이 없으면 가장 오래된 구간을 덮어씀
+    SecretKeySlot* slot = &keySlots[0];
+    for (SecretKeySlot& s : keySlots) {
+        if (s.bucket == NO_BUCKET) {
+            slot = &s;
+            break;
+        }
+        if (s.bucket < slot->bucket) slot = &s;
+    }
+    slot->bucket = bucket;
+    return slot;
+}
+
+static bool precomputing = false;   // 다음 구간 키 계산 태스크가 돌고 있는지
+
+static void precomputeTask(void* arg) {
+    uint64_t bucket = *static_cast<uint64_t*>(arg);
+    delete static_cast<uint64_t*>(arg);
+
+    // 계산은 잠금 밖에서 (그동안 현재 구간 키 요청이 기다리지 않도록)
+    String key = deriveSecretKey(bucket);
+
+    lockKeys();
+    if (!findKeyLocked(bucket)) slotForLocked(bucket)->key = key;
+    precomputing = false;
+    unlockKeys();
+
+    vTaskDelete(NULL);
+}
+
+String secret_key(uint64_t millis) {
+    uint64_t bucket = millis / KEY_BUCKET_MS;
+    bool nearEnd = (millis % KEY_BUCKET_MS) >= KEY_BUCKET_MS - KEY_PRECOMPUTE_MS;
+
+    // 현재 구간 키는 잠금 안에서 계산 (여러 태스크가 같은 키를 중복 계산하지 않도록)
+    lockKeys();
+    SecretKeySlot* slot = findKeyLocked(bucket);
+    if (!slot) {
+        slot = slotForLocked(bucket);
+        slot->key = deriveSecretKey(bucket);
+    }
+    String key = slot->key;
+
+    // 경계 직후의 요청이 계산을 기다리지 않도록 다음 구간 키를 백그라운드 태스크에서 미리 준비 (이번 요청은 기다리지 않음)
+    bool precompute = nearEnd && !precomputing && !findKeyLocked(bucket + 1);
+    if (precompute) precomputing = true;
+    unlockKeys();
+
+    if (precompute) {
+        uint64_t* next = new uint64_t(bucket + 1);
+        if (xTaskCreate(precomputeTask, "key_precompute", 3072, next, 1, nullptr) != pdPASS) {
+            delete next;
+            lockKeys();
+            precomputing = false;
+            unlockKeys();
+        }
+    }
+
+    return key;
+}
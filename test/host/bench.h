@@ -0,0 +1,23 @@
+#pragma once
+// 호스트 벤치마크 공용: 최소 minMs 동안 반복해서 1회당 시간을 잰다
+#include <chrono>
+#include <cstdio>
+
+template <typename Fn>
+static double nsPerCall(Fn fn, double minMs = 200) {
+  using Clock = std::chrono::steady_clock;
+  size_t iters = 1;
+  for (;;) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < iters; i++) fn();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (ns >= minMs * 1e6) return ns / iters;
+    iters *= 2;
+  }
+}
+
+// 결과를 버리지 못하게 (최적화로 호출이 사라지지 않도록)
+template <typename T>
+static void keep(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
@@ -0,0 +1,82 @@
+// Codec Base64 벤치마크: 바꾸기 전 구현(문자마다 String += / 분기 디코딩)과 비교
+#include "bench.h"
+#include "Codec.h"
+
+#include <vector>
+
+// 이전 Encryption::base64Encode (로그 출력은 빼고 변환만)
+static String oldBase64Encode(const uint8_t* input, size_t length) {
+  const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  String output;
+  output.reserve(((length + 2) / 3) * 4);
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t octet_a = i < length ? input[i] : 0;
+    uint32_t octet_b = i + 1 < length ? input[i + 1] : 0;
+    uint32_t octet_c = i + 2 < length ? input[i + 2] : 0;
+    uint32_t triple = (octet_a << 16) + (octet_b << 8) + octet_c;
+    output += base64_chars[(triple >> 18) & 63];
+    output += base64_chars[(triple >> 12) & 63];
+    output += (i + 1 < length) ? base64_chars[(triple >> 6) & 63] : '=';
+    output += (i + 2 < length) ? base64_chars[triple & 63] : '=';
+  }
+  return output;
+}
+
+// 이전 Encryption::base64DecodeInPlace
+static bool oldBase64DecodeInPlace(uint8_t* buf, size_t len, size_t& outLen) {
+  uint32_t acc = 0;
+  int bits = 0;
+  size_t out = 0;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t c = buf[i];
+    int v;
+    if (c >= 'A' && c <= 'Z') v = c - 'A';
+    else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+    else if (c >= '0' && c <= '9') v = c - '0' + 52;
+    else if (c == '+') v = 62;
+    else if (c == '/') v = 63;
+    else if (c == '=') break;
+    else if (c == '\\' || c == ' ' || c == '\r' || c == '\n') continue;
+    else return false;
+    acc = (acc << 6) | v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      buf[out++] = acc >> bits;
+    }
+  }
+  outLen = out;
+  return true;
+}
+
+int main() {
+  printf("bench_codec (ns/call, 괄호 안은 이전 구현 대비 배수)\n");
+  printf("%8s  %12s %12s %7s  %12s %12s %7s\n", "bytes", "enc old", "enc new", "", "dec old", "dec new", "");
+
+  for (size_t len : {16, 64, 256, 1024, 4096, 16384}) {
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; i++) data[i] = (uint8_t)(i * 131 + 7);
+    String encoded = Codec::base64Encode(data.data(), len);
+    std::vector<uint8_t> work(encoded.length());
+    size_t outLen = 0;
+
+    double encOld = nsPerCall([&] { keep(oldBase64Encode(data.data(), len)); });
+    double encNew = nsPerCall([&] { keep(Codec::base64Encode(data.data(), len)); });
+
+    // 제자리 디코딩이므로 매번 원문을 다시 복사 (복사 비용은 양쪽에 같음)
+    double decOld = nsPerCall([&] {
+      memcpy(work.data(), encoded.c_str(), work.size());
+      oldBase64DecodeInPlace(work.data(), work.size(), outLen);
+      keep(work[0]);
+    });
+    double decNew = nsPerCall([&] {
+      memcpy(work.data(), encoded.c_str(), work.size());
+      Codec::base64Decode((const char*)work.data(), work.size(), work.data(), outLen);
+      keep(work[0]);
+    });
+
+    printf("%8zu  %12.0f %12.0f (%4.1fx)  %12.0f %12.0f (%4.1fx)\n",
+           len, encOld, encNew, encOld / encNew, decOld, decNew, decOld / decNew);
+  }
+  return 0;
+}
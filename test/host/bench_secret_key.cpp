@@ -0,0 +1,45 @@
+// secret_key 벤치마크: 구간마다 새로 계산하는 비용과 캐시에서 꺼내는 비용
+#include "bench.h"
+#include "secret_key.h"
+
+#include <chrono>
+#include <thread>
+
+static const uint64_t BUCKET_MS = 10000000;
+
+int main() {
+  printf("bench_secret_key (ns/call)\n");
+
+  // 매번 다른 구간 → 캐시가 없던 이전 구현처럼 매 호출 계산
+  uint64_t bucket = 1000;
+  double derive = nsPerCall([&] { keep(secret_key(bucket++ * BUCKET_MS)); });
+
+  // 같은 구간 → 캐시 (잠금 + String 복사)
+  uint64_t now = 2000 * BUCKET_MS + 12345;
+  secret_key(now);
+  double cached = nsPerCall([&] { keep(secret_key(now++)); });
+
+  printf("  계산 (캐시 없음)   %10.0f\n", derive);
+  printf("  캐시               %10.0f  (%.0fx)\n", cached, derive / cached);
+
+  // 경계 직후 첫 호출: 구간 끝 10분 안에 호출이 있었으면 다음 키가 백그라운드에서 미리 계산돼 있다
+  const int ROUNDS = 50;
+  double withPrecompute = 0, withoutPrecompute = 0;
+  for (int i = 0; i < ROUNDS; i++) {
+    uint64_t boundary = (5000 + i * 2) * BUCKET_MS;
+
+    secret_key(boundary - BUCKET_MS);   // 구간 앞부분: 미리 계산하지 않음
+    auto start = std::chrono::steady_clock::now();
+    keep(secret_key(boundary));
+    withoutPrecompute += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    secret_key(boundary + BUCKET_MS - 1000);   // 구간 끝 10분 안
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    start = std::chrono::steady_clock::now();
+    keep(secret_key(boundary + BUCKET_MS));
+    withPrecompute += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  printf("  경계 직후 첫 호출  %10.0f  (미리 계산 없음)\n", withoutPrecompute / ROUNDS);
+  printf("  경계 직후 첫 호출  %10.0f  (미리 계산됨)\n", withPrecompute / ROUNDS);
+  return 0;
+}
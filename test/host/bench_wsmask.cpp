@@ -0,0 +1,30 @@
+// wsMask 벤치마크: 이전 바이트 단위 루프와 비교 (정렬된 시작 / 1바이트 어긋난 시작)
+#include "bench.h"
+#include "WsMask.h"
+
+#include <vector>
+
+// 이전 wsUnmask
+static void byteMask(uint8_t* data, size_t len, const uint8_t* mask, size_t offset) {
+  for (size_t i = 0; i < len; i++) data[i] ^= mask[(offset + i) & 3];
+}
+
+int main() {
+  const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+  std::vector<uint8_t> buf(65536 + 16);
+
+  printf("bench_wsmask (ns/call, 괄호 안은 바이트 루프 대비 배수)\n");
+  printf("%8s  %10s %10s %7s  %10s %10s %7s\n", "bytes", "byte", "word", "", "byte+1", "word+1", "");
+  for (size_t len = 16; len <= 65536; len *= 4) {
+    // std::vector 데이터는 충분히 정렬돼 있음, +1 은 페이로드가 홀수 위치에서 시작하는 경우
+    uint8_t* aligned = buf.data();
+    uint8_t* odd = buf.data() + 1;
+    double byteA = nsPerCall([&] { byteMask(aligned, len, mask, 0); keep(aligned[0]); });
+    double wordA = nsPerCall([&] { wsMask(aligned, len, mask, 0); keep(aligned[0]); });
+    double byteO = nsPerCall([&] { byteMask(odd, len, mask, 0); keep(odd[0]); });
+    double wordO = nsPerCall([&] { wsMask(odd, len, mask, 0); keep(odd[0]); });
+    printf("%8zu  %10.0f %10.0f (%4.1fx)  %10.0f %10.0f (%4.1fx)\n",
+           len, byteA, wordA, byteA / wordA, byteO, wordO, byteO / wordO);
+  }
+  return 0;
+}
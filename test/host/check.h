@@ -0,0 +1,30 @@
+#pragma once
+// 호스트 테스트 공용 검사 매크로 (실패를 모두 출력하고 main 에서 종료 코드로 반환)
+#include <cstdio>
+#include <string>
+
+static int g_failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      g_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_STR(actual, expected) \
+  do { \
+    std::string a_ = (actual); \
+    std::string e_ = (expected); \
+    if (a_ != e_) { \
+      std::printf("FAIL %s:%d: %s\n  got      %s\n  expected %s\n", __FILE__, __LINE__, #actual, a_.c_str(), e_.c_str()); \
+      g_failures++; \
+    } \
+  } while (0)
+
+static int finish(const char* name) {
+  if (g_failures) std::printf("%s: %d failure(s)\n", name, g_failures);
+  else std::printf("%s: ok\n", name);
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+// 호스트 테스트용 최소 Arduino 대체 (라이브러리 소스가 쓰는 부분만)
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define F(s) (s)
+
+using std::min;
+using std::max;
+
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+
+  unsigned int length() const { return _s.size(); }
+  const char* c_str() const { return _s.c_str(); }
+  bool isEmpty() const { return _s.empty(); }
+  void reserve(unsigned int n) { _s.reserve(n); }
+  bool concat(const char* s, unsigned int n) { _s.append(s, n); return true; }
+
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* s) { _s += s; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  bool operator==(const String& o) const { return _s == o._s; }
+  bool operator==(const char* s) const { return _s == s; }
+  bool operator!=(const String& o) const { return _s != o._s; }
+
+  int indexOf(char c) const {
+    size_t p = _s.find(c);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned int from, unsigned int to) const { return String(_s.substr(from, to - from)); }
+
+private:
+  std::string _s;
+};
+
+struct HostSerial {
+  void println(const char* s = "") { std::printf("%s\n", s); }
+  void println(const String& s) { std::printf("%s\n", s.c_str()); }
+  template <typename... A>
+  void printf(const char* fmt, A... a) { std::printf(fmt, a...); }
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
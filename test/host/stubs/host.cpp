@@ -0,0 +1,48 @@
+// 호스트 테스트용 Arduino/FreeRTOS 함수 구현
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+HostSerial Serial;
+
+static const auto START = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new std::mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t) {
+  static_cast<std::mutex*>(s)->lock();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  static_cast<std::mutex*>(s)->unlock();
+  return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char*, uint32_t, void* arg, UBaseType_t, TaskHandle_t* handle) {
+  std::thread(fn, arg).detach();
+  if (handle) *handle = nullptr;
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t) {
+}
@@ -0,0 +1,129 @@
+// Codec Base64/16진수 변환 검사 (RFC 4648 벡터, 제자리 디코딩, 건너뛰는 문자)
+#include "check.h"
+#include "Codec.h"
+
+#include <string>
+#include <vector>
+
+static std::string decode(const std::string& in, bool* ok = nullptr) {
+  std::vector<uint8_t> out(Codec::base64DecodedMaxLength(in.size()));
+  size_t outLen = 0;
+  bool r = Codec::base64Decode(in.data(), in.size(), out.data(), outLen);
+  if (ok) *ok = r;
+  return std::string((const char*)out.data(), r ? outLen : 0);
+}
+
+static void testRfc4648Vectors() {
+  // RFC 4648 10절
+  static const char* const VECTORS[][2] = {
+    {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+    {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+  };
+  for (const auto& v : VECTORS) {
+    const std::string plain = v[0];
+    char buf[16];
+    size_t n = Codec::base64Encode((const uint8_t*)plain.data(), plain.size(), buf);
+    CHECK(n == Codec::base64EncodedLength(plain.size()));
+    CHECK_STR(buf, v[1]);
+    CHECK_STR(Codec::base64Encode((const uint8_t*)plain.data(), plain.size()).c_str(), v[1]);
+
+    bool ok = false;
+    CHECK_STR(decode(v[1], &ok), plain);
+    CHECK(ok);
+  }
+}
+
+static void testRoundTrip() {
+  // String 판은 48바이트 단위로 나눠 붙이므로 그 경계 주변 길이까지
+  std::vector<uint8_t> data(300);
+  for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)(i * 37 + 11);
+  for (size_t len = 0; len <= data.size(); len++) {
+    String enc = Codec::base64Encode(data.data(), len);
+    CHECK(enc.length() == Codec::base64EncodedLength(len));
+    bool ok = false;
+    std::string dec = decode(enc.c_str(), &ok);
+    CHECK(ok && dec == std::string((const char*)data.data(), len));
+  }
+}
+
+static void testInPlaceDecode() {
+  // 암호문/봉투를 받은 버퍼 그대로 디코딩하는 경로 (Encryption)
+  std::vector<uint8_t> data(100);
+  for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)(255 - i);
+  String enc = Codec::base64Encode(data.data(), data.size());
+
+  std::vector<uint8_t> buf(enc.c_str(), enc.c_str() + enc.length());
+  size_t outLen = 0;
+  CHECK(Codec::base64Decode((const char*)buf.data(), buf.size(), buf.data(), outLen));
+  CHECK(outLen == data.size());
+  CHECK(memcmp(buf.data(), data.data(), data.size()) == 0);
+
+  // 이스케이프가 섞여 빠른 경로와 느린 경로를 오가는 경우도 제자리로
+  std::string escaped = "Zm9v\\/\\/\\/\\/YmFyZm9v";
+  std::vector<uint8_t> buf2(escaped.begin(), escaped.end());
+  CHECK(Codec::base64Decode((const char*)buf2.data(), buf2.size(), buf2.data(), outLen));
+  CHECK(std::string((const char*)buf2.data(), outLen) == "foo\xff\xff\xff" "barfoo");
+}
+
+static void testSkippedCharacters() {
+  // JSON 에서 꺼낸 값 그대로: "\/" 이스케이프, 줄바꿈, 공백, 탭
+  bool ok = false;
+  CHECK_STR(decode("Zm9v\nYmFy", &ok), "foobar");
+  CHECK(ok);
+  CHECK_STR(decode(" Zm9v YmFy \r\n", &ok), "foobar");
+  CHECK(ok);
+  CHECK_STR(decode("Zm9v\tYmE=", &ok), "fooba");
+  CHECK(ok);
+
+  // '/' 가 들어가는 값: 0xff 0xff 0xff -> "////", JSON 에서는 "\/\/\/\/"
+  std::string slashes = decode("\\/\\/\\/\\/", &ok);
+  CHECK(ok && slashes == std::string(3, '\xff'));
+  CHECK_STR(decode("Zm9v\\/\\/\\/\\/YmFy", &ok), "foo\xff\xff\xff" "bar");
+  CHECK(ok);
+
+  // '=' 뒤는 읽지 않음
+  CHECK_STR(decode("Zg==garbage!", &ok), "f");
+  CHECK(ok);
+}
+
+static void testInvalidInput() {
+  bool ok = true;
+  decode("Zm9v*mFy", &ok);
+  CHECK(!ok);
+  decode("Zm9vYmF\x80", &ok);
+  CHECK(!ok);
+}
+
+static void testHex() {
+  const uint8_t bytes[] = {0x00, 0x01, 0x7f, 0x80, 0xab, 0xff};
+  char buf[16];
+  Codec::hexEncode(bytes, sizeof(bytes), buf);
+  CHECK_STR(buf, "00017f80abff");
+  CHECK_STR(Codec::hexEncode(bytes, sizeof(bytes)).c_str(), "00017f80abff");
+
+  uint8_t out[8];
+  size_t outLen = 0;
+  CHECK(Codec::hexDecode("00017F80abFF", 12, out, outLen));
+  CHECK(outLen == sizeof(bytes) && memcmp(out, bytes, sizeof(bytes)) == 0);
+  CHECK(!Codec::hexDecode("abc", 3, out, outLen));
+  CHECK(!Codec::hexDecode("zz", 2, out, outLen));
+
+  // String 판은 32바이트 단위로 나눠 붙임
+  std::vector<uint8_t> data(70);
+  for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)i;
+  String hex = Codec::hexEncode(data.data(), data.size());
+  CHECK(hex.length() == data.size() * 2);
+  std::vector<uint8_t> back(data.size());
+  CHECK(Codec::hexDecode(hex.c_str(), hex.length(), back.data(), outLen));
+  CHECK(outLen == data.size() && back == data);
+}
+
+int main() {
+  testRfc4648Vectors();
+  testRoundTrip();
+  testInPlaceDecode();
+  testSkippedCharacters();
+  testInvalidInput();
+  testHex();
+  return finish("test_codec");
+}
@@ -0,0 +1,75 @@
+// Sha256 (소프트웨어 구현) NIST 벡터와 secret_key 기준값 검사
+#include "check.h"
+#include "Sha256.h"
+#include "secret_key.h"
+
+#include <string>
+
+static String hexOf(const std::string& s) {
+  return Sha256::hexDigest((const uint8_t*)s.data(), s.size());
+}
+
+// 한 번에 넣은 결과와 step 바이트씩 나눠 넣은 결과가 같은지
+static String hexChunked(const std::string& s, size_t step) {
+  Sha256 sha;
+  for (size_t i = 0; i < s.size(); i += step) {
+    sha.update((const uint8_t*)s.data() + i, std::min(step, s.size() - i));
+  }
+  uint8_t out[Sha256::HASH_SIZE];
+  sha.finish(out);
+
+  char text[Sha256::HASH_SIZE * 2 + 1];
+  for (size_t i = 0; i < Sha256::HASH_SIZE; i++) sprintf(text + i * 2, "%02x", out[i]);
+  return String(text);
+}
+
+static void testNistVectors() {
+  // FIPS 180-2 / NIST CSRC 예제
+  CHECK_STR(hexOf("").c_str(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  CHECK_STR(hexOf("abc").c_str(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  CHECK_STR(hexOf("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq").c_str(),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  CHECK_STR(hexOf(std::string(1000000, 'a')).c_str(),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+static void testChunkedUpdate() {
+  // 블록(64바이트) 경계와 패딩 경계(55/56바이트) 주변 길이를 여러 조각 크기로
+  for (size_t len : {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000}) {
+    std::string s;
+    for (size_t i = 0; i < len; i++) s += (char)('a' + i % 26);
+    String whole = hexOf(s);
+    for (size_t step : {1, 3, 63, 64, 65}) {
+      CHECK(hexChunked(s, step) == whole);
+    }
+  }
+}
+
+static void testReuseAfterBegin() {
+  Sha256 sha;
+  uint8_t out[Sha256::HASH_SIZE];
+  sha.update((const uint8_t*)"garbage", 7);
+  sha.finish(out);
+  sha.begin();
+  sha.update((const uint8_t*)"abc", 3);
+  sha.finish(out);
+  CHECK(out[0] == 0xba && out[31] == 0xad);
+}
+
+static void testSecretKey() {
+  // 기존(baseline) 구현으로 계산해 둔 값: 해시 방식이나 캐시를 바꿔도 서버와 맞는 키가 나와야 한다
+  CHECK_STR(secret_key(0).c_str(), "88ef2");
+  CHECK_STR(secret_key(9999999ULL).c_str(), "88ef2");
+  CHECK_STR(secret_key(10000000ULL).c_str(), "7");
+  CHECK_STR(secret_key(1700000000000ULL).c_str(), "372ad8a522476bbca7178680650b3a75e5845da5c042ae");
+  // 캐시된 값도 같아야 한다
+  CHECK_STR(secret_key(1700000000001ULL).c_str(), "372ad8a522476bbca7178680650b3a75e5845da5c042ae");
+}
+
+int main() {
+  testNistVectors();
+  testChunkedUpdate();
+  testReuseAfterBegin();
+  testSecretKey();
+  return finish("test_sha256");
+}
@@ -0,0 +1,67 @@
+// wsMask 를 바이트 단위 XOR 과 비교: 시작 정렬(앞부분), 길이(뒷부분), 페이로드 안 위치(offset) 전부
+#include "check.h"
+#include "WsMask.h"
+
+#include <vector>
+
+static void byteMask(uint8_t* data, size_t len, const uint8_t* mask, size_t offset) {
+  for (size_t i = 0; i < len; i++) data[i] ^= mask[(offset + i) & 3];
+}
+
+static void testAgainstByteLoop() {
+  const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+  const size_t GUARD = 8;
+  std::vector<uint8_t> src(GUARD + 8 + 300 + GUARD);
+  for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)(i * 29 + 3);
+
+  int mismatches = 0;
+  for (size_t align = 0; align < 8; align++) {
+    for (size_t len = 0; len <= 300; len++) {
+      for (size_t offset = 0; offset < 8; offset++) {
+        std::vector<uint8_t> expected = src;
+        std::vector<uint8_t> actual = src;
+        byteMask(expected.data() + GUARD + align, len, mask, offset);
+        wsMask(actual.data() + GUARD + align, len, mask, offset);
+        // 범위 밖(GUARD) 바이트도 그대로여야 함
+        if (actual != expected) mismatches++;
+      }
+    }
+  }
+  CHECK(mismatches == 0);
+}
+
+static void testSplitPieces() {
+  // 수신 경로처럼 한 페이로드를 여러 조각으로 나눠 offset 을 이어 가며 적용
+  const uint8_t mask[4] = {0xde, 0xad, 0xbe, 0xef};
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)i;
+  std::vector<uint8_t> expected = data;
+  byteMask(expected.data(), expected.size(), mask, 0);
+
+  for (size_t piece : {1, 3, 5, 7, 13, 64, 333}) {
+    std::vector<uint8_t> actual = data;
+    for (size_t off = 0; off < actual.size(); off += piece) {
+      size_t n = std::min(piece, actual.size() - off);
+      wsMask(actual.data() + off, n, mask, off);
+    }
+    CHECK(actual == expected);
+  }
+}
+
+static void testRoundTrip() {
+  const uint8_t mask[4] = {1, 2, 3, 4};
+  std::vector<uint8_t> data(257);
+  for (size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)(i ^ 0x5a);
+  std::vector<uint8_t> work = data;
+  wsMask(work.data() + 1, work.size() - 1, mask, 2);
+  CHECK(work != data);
+  wsMask(work.data() + 1, work.size() - 1, mask, 2);
+  CHECK(work == data);
+}
+
+int main() {
+  testAgainstByteLoop();
+  testSplitPieces();
+  testRoundTrip();
+  return finish("test_wsmask");
+}